@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <windows.h>
+
+#include "../circular_buffer/CircularBuffer.hpp"
+#include "../log_project/LogFileManager.hpp"
+#include "../parallel_processor/ParallelProcessor.hpp"
+
+// ======================= 벤치마크 하니스 =======================
+// 세 컴포넌트 공통 회귀 벤치마크. 한 번 재고 끝나는 기존 main()의
+// high_resolution_clock 측정과 달리, 워밍업 후 반복 측정해서
+// median / p95 / min을 보고한다. 릴리스 전 회귀 게이트용.
+//
+// 사용법: benchmark.exe [N] [threads] [repeats]
+//   N       : 원소 수        (기본 1,000,000)
+//   threads : 워커 스레드 수 (기본 4)
+//   repeats : 측정 반복 횟수 (기본 11, 워밍업 2회 별도)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double median;
+    double p95;
+    double min;
+};
+
+// fn()을 warmup회 버리고 repeats회 측정 (단위: ms)
+template <typename Fn>
+Result measure(std::size_t repeats, std::size_t warmup, Fn fn) {
+    for (std::size_t i = 0; i < warmup; ++i) fn();
+
+    std::vector<double> samples;
+    samples.reserve(repeats);
+    for (std::size_t i = 0; i < repeats; ++i) {
+        const auto t0 = Clock::now();
+        fn();
+        const auto t1 = Clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto at = [&](double q) {
+        const auto idx = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+        return samples[idx];
+    };
+    return { at(0.5), at(0.95), samples.front() };
+}
+
+void report(const std::string& name, const Result& r, const std::string& unit = "ms") {
+    std::cout << std::left << std::setw(38) << name
+              << " median=" << std::fixed << std::setprecision(3) << std::setw(9) << r.median
+              << " p95=" << std::setw(9) << r.p95
+              << " min=" << std::setw(9) << r.min
+              << " " << unit << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+
+    const std::size_t N       = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    const std::size_t repeats = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 11;
+    const std::size_t warmup  = 2;
+
+    std::cout << "N=" << N << " threads=" << threads << " repeats=" << repeats
+              << " (warmup " << warmup << ")\n\n";
+
+    // --- 1) parallel_map vs sequential_map --------------------------------
+    std::vector<int> pixelData(N);
+    std::iota(pixelData.begin(), pixelData.end(), 0);
+    ParallelProcessor<int> processor(threads);
+    auto brighten = [](int p) {
+        int v = p + 50;
+        if (v > 255) v = 255;
+        if (v < 0) v = 0;
+        return v;
+    };
+
+    report("sequential_map (brighten)", measure(repeats, warmup, [&] {
+        volatile int sink = sequential_map(pixelData, brighten)[0];
+        (void)sink;
+    }));
+    report("parallel_map (brighten)", measure(repeats, warmup, [&] {
+        volatile int sink = processor.parallel_map(pixelData, brighten)[0];
+        (void)sink;
+    }));
+    std::vector<int> reused;
+    reused.reserve(N);
+    report("parallel_map_into (reused buffer)", measure(repeats, warmup, [&] {
+        processor.parallel_map_into(pixelData, brighten, reused);
+    }));
+
+    // --- 2) CircularBuffer::push_back 처리량 ------------------------------
+    {
+        CircularBuffer<double> buf(1 << 16); // 2^k → 비트마스크 래핑 경로
+        report("CircularBuffer::push_back x N", measure(repeats, warmup, [&] {
+            for (std::size_t i = 0; i < N; ++i) buf.push_back(static_cast<double>(i));
+        }));
+        report("CircularBuffer::push_back_bulk x N", measure(repeats, warmup, [&] {
+            const std::size_t blockLen = 4096;
+            std::vector<double> block(blockLen, 1.0);
+            for (std::size_t done = 0; done < N; done += blockLen)
+                buf.push_back_bulk(block.data(), std::min(blockLen, N - done));
+        }));
+    }
+
+    // --- 3) LogFileManager::writeLog 지연 ---------------------------------
+    {
+        LogFileManager manager;
+        manager.openLogFile("bench.log");
+        const std::size_t lines = 1000; // 반복당 기록할 줄 수
+        auto r = measure(repeats, warmup, [&] {
+            for (std::size_t i = 0; i < lines; ++i)
+                manager.writeLog("bench.log", "benchmark line payload 0123456789");
+        });
+        // ms/1000줄 → 줄당 µs로 환산해 보고
+        report("LogFileManager::writeLog (per line)",
+               { r.median, r.p95, r.min }, "ms/1000 lines");
+
+        // 계측 스냅샷 (INSTR_ENABLED=0 빌드면 전부 0)
+        const auto ls = manager.perf_stats();
+        std::cout << "\n[perf] logger: flushes=" << ls.flushes
+                  << " flush_p95<=" << ls.flush_p95_ns << "ns"
+                  << " queue_hwm=" << ls.queue_depth_hwm << "\n";
+    }
+
+    const auto pp = processor.perf_stats();
+    std::cout << "[perf] processor: calls=" << pp.calls
+              << " wall_p50<=" << pp.wall_p50_ns << "ns"
+              << " wall_p95<=" << pp.wall_p95_ns << "ns"
+              << " avg_imbalance=" << pp.avg_imbalance_ns << "ns\n";
+
+    return 0;
+}
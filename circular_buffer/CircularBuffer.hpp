@@ -0,0 +1,581 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "Instrumentation.hpp"
+
+// ======================= CircularBuffer =======================
+// 저장소는 raw 메모리이고, 원소는 push 시점에 placement-new로 생성된다.
+// make_unique<T[]>처럼 용량 전체를 미리 기본 생성하지 않으므로
+// 기본 생성자가 비싸거나 없는 타입도 담을 수 있다.
+// 불변식: [head_, head_+size_) 논리 구간의 슬롯만 살아 있다.
+//
+// 저장 정책은 두 번째 템플릿 인자 N으로 고른다:
+//   N == 0 (기본) : 런타임 용량, raw 힙 저장 — 기존 CircularBuffer<T>와 동일
+//   N >  0        : std::array식 인라인 저장. 용량/마스크가 constexpr라서
+//                   힙 할당과 포인터 간접 참조가 없고, 2^k 용량이면 래핑이
+//                   컴파일타임 비트마스크 AND로 접힌다. 연결 객체마다
+//                   작은 버퍼(16~64칸)를 내장하는 용도.
+namespace cb_detail {
+
+constexpr bool isPow2(std::size_t v) noexcept { return v != 0 && (v & (v - 1)) == 0; }
+
+// N > 0: 인라인(비초기화) 저장. 용량/마스크는 컴파일타임 상수.
+template <typename T, std::size_t N>
+struct RingStorage {
+    static constexpr std::size_t cap_  = N;
+    static constexpr std::size_t mask_ = isPow2(N) ? N - 1 : 0;
+
+    RingStorage() = default;
+    // 인라인 바이트는 훔칠 수 없다: 원소 이동은 CircularBuffer 쪽 몫
+    RingStorage(RingStorage&&) noexcept {}
+    RingStorage& operator=(RingStorage&&) noexcept { return *this; }
+
+    T*       data()       noexcept { return reinterpret_cast<T*>(bytes_); }
+    const T* data() const noexcept { return reinterpret_cast<const T*>(bytes_); }
+
+    alignas(alignof(T)) unsigned char bytes_[N * sizeof(T)];
+};
+
+// N == 0: 런타임 용량. 생성하지 않은 raw 힙 메모리를 unique_ptr로 소유.
+template <typename T>
+struct RingStorage<T, 0> {
+    explicit RingStorage(std::size_t capacity)
+        : cap_(capacity), mask_(isPow2(capacity) ? capacity - 1 : 0),
+          mem_(allocate(capacity)) {
+        if (cap_ == 0) throw std::invalid_argument("capacity must be > 0");
+    }
+    RingStorage(RingStorage&&) noexcept = default;
+    RingStorage& operator=(RingStorage&&) noexcept = default;
+
+    // 생성하지 않은 raw 메모리 할당/해제. 해제 쪽은 unique_ptr의 deleter로.
+    struct RawDeleter {
+        void operator()(T* p) const noexcept {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+    };
+    static T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    T*       data()       noexcept { return mem_.get(); }
+    const T* data() const noexcept { return mem_.get(); }
+
+    std::size_t cap_;
+    std::size_t mask_; // cap_가 2^k이면 cap_-1, 아니면 0
+    std::unique_ptr<T[], RawDeleter> mem_;
+};
+
+} // namespace cb_detail
+
+template <typename T, std::size_t N = 0>
+class CircularBuffer : private cb_detail::RingStorage<T, N> {
+    using Store = cb_detail::RingStorage<T, N>;
+    using Store::cap_;
+    using Store::mask_;
+    using Store::data;
+
+public:
+    // 런타임 용량 (N == 0 전용)
+    template <std::size_t M = N, std::enable_if_t<M == 0, int> = 0>
+    explicit CircularBuffer(std::size_t capacity)
+        : Store(capacity), head_(0), tail_(0), size_(0) {}
+
+    // 컴파일타임 용량 (N > 0 전용): 할당 없이 즉시 사용 가능
+    template <std::size_t M = N, std::enable_if_t<M != 0, int> = 0>
+    CircularBuffer() noexcept : head_(0), tail_(0), size_(0) {}
+
+    ~CircularBuffer() { destroyAll(); }
+
+    // raw 저장소 특성상 복사는 지원하지 않는다. 이동은 소유권만 넘긴다
+    // (인라인 변형은 포인터를 훔칠 수 없으므로 원소 단위로 이동).
+    CircularBuffer(const CircularBuffer&) = delete;
+    CircularBuffer& operator=(const CircularBuffer&) = delete;
+    CircularBuffer(CircularBuffer&& other) noexcept(N == 0 || std::is_nothrow_move_constructible_v<T>)
+        : Store(std::move(static_cast<Store&>(other))),
+          head_(other.head_), tail_(other.tail_), size_(other.size_) {
+        if constexpr (N == 0) {
+            other.size_ = 0; // 이동 후 원본은 파괴만 가능
+        } else {
+            head_ = 0; tail_ = 0; size_ = 0;
+            moveElementsFrom(other);
+        }
+    }
+    CircularBuffer& operator=(CircularBuffer&& other) noexcept(N == 0 || std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            destroyAll();
+            Store::operator=(std::move(static_cast<Store&>(other)));
+            if constexpr (N == 0) {
+                head_ = other.head_; tail_ = other.tail_; size_ = other.size_;
+                other.size_ = 0;
+            } else {
+                head_ = 0; tail_ = 0; size_ = 0;
+                moveElementsFrom(other);
+            }
+        }
+        return *this;
+    }
+
+    // 슬롯에 직접 생성. 가득 차 있으면 살아 있는 슬롯에 대입(overwrite 정책),
+    // 아니면 죽은 슬롯에 placement-new.
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (size_ == cap_) {
+            data()[tail_] = T(std::forward<Args>(args)...);
+            head_ = wrap(head_ + 1); // 가장 오래된 것 버림
+            overwrites_.add();
+        } else {
+            ::new (static_cast<void*>(&data()[tail_])) T(std::forward<Args>(args)...);
+            ++size_;
+        }
+        tail_ = wrap(tail_ + 1);
+        pushes_.add();
+        occupancyHwm_.observe(size_);
+    }
+
+    void push_back(const T& item) { emplace_back(item); }
+    void push_back(T&& item)      { emplace_back(std::move(item)); }
+
+    void pop_front() {
+        if (empty()) throw std::out_of_range("pop_front on empty buffer");
+        data()[head_].~T();
+        head_ = wrap(head_ + 1);
+        --size_;
+        pops_.add();
+    }
+
+    T&       front()       { if (empty()) throw std::out_of_range("front on empty"); return data()[head_]; }
+    const T& front() const { if (empty()) throw std::out_of_range("front on empty"); return data()[head_]; }
+
+    T&       back()        { if (empty()) throw std::out_of_range("back on empty");  return data()[wrap(tail_ + cap_ - 1)]; }
+    const T& back()  const { if (empty()) throw std::out_of_range("back on empty");  return data()[wrap(tail_ + cap_ - 1)]; }
+
+    std::size_t size()     const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return cap_;  }
+    bool        empty()    const noexcept { return size_ == 0; }
+
+    // ---- 블록 단위 입출력 / 연속 구간 접근 ----
+    // 내용물은 내부 배열에서 최대 2개의 연속 구간으로 존재한다:
+    //   구간1 = [head_, min(head_+size_, cap_)), 구간2 = 랩어라운드된 나머지.
+    // 블록 API는 원소 단위 래핑 검사 대신 구간별 std::copy 한두 번으로 처리한다.
+    struct Span      { T* ptr;       std::size_t len; };
+    struct ConstSpan { const T* ptr; std::size_t len; };
+
+    // count개를 한 번에 push. push_back과 동일한 overwrite 정책:
+    // 가득 차면 가장 오래된 것부터 밀려난다 (count >= cap_이면 마지막 cap_개만 남음).
+    // trivially copyable 타입은 슬롯 생존 여부와 무관하게 구간별 memcpy로
+    // 처리하고, 그 외 타입은 생성/대입을 구분해야 하므로 원소 단위로 민다.
+    void push_back_bulk(const T* src, std::size_t count) {
+        if (count == 0) return;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            // 원소 단위 push와 동일한 의미의 계측: 빈자리를 넘는 만큼이 유실
+            if (count > cap_ - size_) overwrites_.add(count - (cap_ - size_));
+            pushes_.add(count);
+            if (count >= cap_) { // 버퍼 전체가 교체됨
+                src += count - cap_;
+                std::memcpy(&data()[0], src, cap_ * sizeof(T));
+                head_ = 0; tail_ = 0; size_ = cap_;
+                occupancyHwm_.observe(size_);
+                return;
+            }
+            const std::size_t first = std::min(count, cap_ - tail_);
+            std::memcpy(&data()[tail_], src, first * sizeof(T));
+            std::memcpy(&data()[0], src + first, (count - first) * sizeof(T)); // 랩어라운드 구간
+            const std::size_t overwritten = (size_ + count > cap_) ? size_ + count - cap_ : 0;
+            head_ = wrap(head_ + overwritten);
+            tail_ = wrap(tail_ + count);
+            size_ = size_ + count - overwritten;
+            occupancyHwm_.observe(size_);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) push_back(src[i]);
+        }
+    }
+
+    // 최대 count개를 dst로 꺼낸다. 실제 꺼낸 개수를 반환 (빈 버퍼면 0).
+    // dst의 슬롯은 이미 생성돼 있다고 가정한다 (기존 std::copy 의미 유지).
+    std::size_t pop_front_bulk(T* dst, std::size_t count) {
+        const std::size_t n = std::min(count, size_);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            const std::size_t first = std::min(n, cap_ - head_);
+            std::memcpy(dst, &data()[head_], first * sizeof(T));
+            std::memcpy(dst + first, &data()[0], (n - first) * sizeof(T)); // 랩어라운드 구간
+            head_ = wrap(head_ + n);
+            size_ -= n;
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[i] = std::move(data()[head_]);
+                data()[head_].~T();
+                head_ = wrap(head_ + 1);
+            }
+            size_ -= n;
+        }
+        pops_.add(n);
+        return n;
+    }
+
+    // 현재 내용(head→tail 순)을 dst로 일괄 복사한다. 버퍼 상태는 바뀌지 않는다.
+    // 복사한 개수를 반환 (최대 maxCount). trivially copyable이면 구간별
+    // memcpy 두 번이 전부라서, 메트릭 스레드가 락을 이 호출 동안만 잡으면
+    // 생산자 정지 시간이 memcpy 비용으로 바운드된다 (락은 호출자 몫).
+    std::size_t snapshot(T* dst, std::size_t maxCount) const {
+        const std::size_t n = std::min(maxCount, size_);
+        const std::size_t first = std::min(n, cap_ - head_);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(dst, &data()[head_], first * sizeof(T));
+            std::memcpy(dst + first, &data()[0], (n - first) * sizeof(T)); // 랩어라운드 구간
+        } else {
+            std::copy(&data()[head_], &data()[head_] + first, dst);
+            std::copy(&data()[0], &data()[0] + (n - first), dst + first);
+        }
+        return n;
+    }
+
+    // 내용 전체를 비우면서 소비자 콜백에 연속 구간(포인터+길이)을 통째로
+    // 넘긴다. head_는 원소당이 아니라 구간당 한 번만 전진하므로
+    // (구간은 최대 2개) 소비 비용이 콜백 본문에 지배된다. 꺼낸 개수 반환.
+    template <typename Fn>
+    std::size_t drain(Fn&& fn) {
+        std::size_t total = 0;
+        while (size_ != 0) {
+            const Span s = front_span();
+            fn(static_cast<const T*>(s.ptr), s.len);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (std::size_t i = 0; i < s.len; ++i) s.ptr[i].~T();
+            }
+            head_ = wrap(head_ + s.len);
+            size_ -= s.len;
+            total += s.len;
+        }
+        pops_.add(total);
+        return total;
+    }
+
+    // ---- 통계 (단일 융합 패스) ----
+    // max_element + accumulate 식의 다중 패스 대신, (최대 2개의) 연속 raw
+    // 구간을 단순 루프로 한 번만 돌아 min/max/합/제곱합을 동시에 누적한다.
+    // 래핑 검사 없는 포인터 루프라서 -O2 이상에서 컴파일러 SIMD 자동
+    // 벡터화가 가능한 형태다 (부동소수는 -ffast-math일 때 완전 벡터화).
+    struct Stats {
+        T      min;
+        T      max;
+        double mean;
+        double variance;
+    };
+
+    Stats stats() const {
+        static_assert(std::is_arithmetic_v<T>, "stats()는 산술 타입 전용");
+        if (empty()) throw std::out_of_range("stats on empty");
+
+        T minv = data()[head_], maxv = minv;
+        double sum = 0.0, sumSq = 0.0;
+        auto accumulateSegment = [&](const T* p, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                const T v = p[i];
+                if (v < minv) minv = v;
+                if (maxv < v) maxv = v;
+                const double d = static_cast<double>(v);
+                sum   += d;
+                sumSq += d * d;
+            }
+        };
+        const ConstSpan s1 = front_span();
+        const ConstSpan s2 = back_span();
+        accumulateSegment(s1.ptr, s1.len);
+        accumulateSegment(s2.ptr, s2.len);
+
+        const double n    = static_cast<double>(size_);
+        const double mean = sum / n;
+        return { minv, maxv, mean, sumSq / n - mean * mean };
+    }
+
+    // 구간1(가장 오래된 쪽)과 구간2(랩어라운드된 쪽). 비어 있으면 len == 0.
+    Span      front_span()       noexcept { return { &data()[head_], std::min(size_, cap_ - head_) }; }
+    ConstSpan front_span() const noexcept { return { &data()[head_], std::min(size_, cap_ - head_) }; }
+    Span      back_span()        noexcept { const auto f = std::min(size_, cap_ - head_); return { &data()[0], size_ - f }; }
+    ConstSpan back_span()  const noexcept { const auto f = std::min(size_, cap_ - head_); return { &data()[0], size_ - f }; }
+
+    // ---- STL random-access iterator (const/non-const) ----
+    // 내부 인덱스 대신 논리 위치(pos = head로부터의 거리)만 들고 다니고
+    // 역참조 시점에 래핑한다. random_access_iterator_tag라서
+    // std::max_element/accumulate 등이 거리 기반(언롤/벡터화) 경로를 타고,
+    // 버퍼 범위를 청크 단위 병렬 처리에 바로 넘길 수 있다.
+    template <bool IsConst>
+    class Iter {
+        using Buf = std::conditional_t<IsConst, const CircularBuffer, CircularBuffer>;
+        using Ref = std::conditional_t<IsConst, const T&, T&>;
+        using Ptr = std::conditional_t<IsConst, const T*, T*>;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = Ref;
+        using pointer           = Ptr;
+
+        Iter(Buf* buf, std::size_t pos) : buf_(buf), pos_(pos) {}
+        reference operator*()  const { return buf_->data()[buf_->wrap(buf_->head_ + pos_)]; }
+        pointer   operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        Iter& operator++() { ++pos_; return *this; }
+        Iter  operator++(int) { auto tmp = *this; ++pos_; return tmp; }
+        Iter& operator--() { --pos_; return *this; }
+        Iter  operator--(int) { auto tmp = *this; --pos_; return tmp; }
+        Iter& operator+=(difference_type n) { pos_ = static_cast<std::size_t>(static_cast<difference_type>(pos_) + n); return *this; }
+        Iter& operator-=(difference_type n) { return *this += -n; }
+
+        friend Iter operator+(Iter it, difference_type n) { it += n; return it; }
+        friend Iter operator+(difference_type n, Iter it) { it += n; return it; }
+        friend Iter operator-(Iter it, difference_type n) { it -= n; return it; }
+        friend difference_type operator-(const Iter& a, const Iter& b) {
+            return static_cast<difference_type>(a.pos_) - static_cast<difference_type>(b.pos_);
+        }
+
+        friend bool operator==(const Iter& a, const Iter& b){ return a.buf_==b.buf_ && a.pos_==b.pos_; }
+        friend bool operator!=(const Iter& a, const Iter& b){ return !(a==b); }
+        friend bool operator< (const Iter& a, const Iter& b){ return a.pos_ <  b.pos_; }
+        friend bool operator> (const Iter& a, const Iter& b){ return b < a; }
+        friend bool operator<=(const Iter& a, const Iter& b){ return !(b < a); }
+        friend bool operator>=(const Iter& a, const Iter& b){ return !(a < b); }
+    private:
+        Buf* buf_; std::size_t pos_;
+    };
+
+    using iterator       = Iter<false>;
+    using const_iterator = Iter<true>;
+    iterator begin()             { return iterator(this, 0); }
+    iterator end()               { return iterator(this, size_); }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end()   const { return cend();   }
+    const_iterator cbegin() const{ return const_iterator(this, 0); }
+    const_iterator cend()   const{ return const_iterator(this, size_); }
+
+    // ---- 핫패스 계측 스냅샷 ----
+    // stats()는 내용물(값) 통계이므로, 운영 계측 쪽은 perf_stats()로 분리했다.
+    // -DINSTR_ENABLED=0이면 카운터가 no-op 타입이라 전부 0이 나온다.
+    struct PerfStats {
+        std::uint64_t pushes;
+        std::uint64_t pops;
+        std::uint64_t overwrites;    // overwrite 정책으로 밀려난 원소 수 (조용한 유실)
+        std::uint64_t occupancy_hwm; // 관측된 최대 점유 원소 수
+    };
+    PerfStats perf_stats() const noexcept {
+        return { pushes_.get(), pops_.get(), overwrites_.get(), occupancyHwm_.get() };
+    }
+
+    // 디버깅/출력용: 내부 인덱스 순서(raw order)로 접근. raw 저장소라
+    // 죽은 슬롯에는 생성된 값이 없으므로 살아 있는 슬롯만 허용한다
+    // (가득 찬 버퍼에서는 0..cap_-1 전부 유효).
+    T at_index(std::size_t i) const {
+        if (i >= cap_) throw std::out_of_range("at_index out of range");
+        const std::size_t offset = i >= head_ ? i - head_ : i + cap_ - head_;
+        if (offset >= size_) throw std::out_of_range("at_index on unconstructed slot");
+        return data()[i];
+    }
+    std::size_t head_index() const { return head_; }
+
+private:
+    // 2의 거듭제곱 용량이면 % (정수 나눗셈) 대신 비트마스크로 래핑.
+    // N == 0이면 생성자에서 자동 감지, N > 0이면 mask_가 constexpr라서
+    // 분기와 마스크가 컴파일타임에 접힌다.
+    std::size_t wrap(std::size_t i) const noexcept { return mask_ ? (i & mask_) : (i % cap_); }
+
+    // 살아 있는 원소만 파괴 (저장소 해제는 Store 몫)
+    void destroyAll() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const Span s1 = front_span();
+            const Span s2 = back_span();
+            for (std::size_t i = 0; i < s1.len; ++i) s1.ptr[i].~T();
+            for (std::size_t i = 0; i < s2.len; ++i) s2.ptr[i].~T();
+        }
+        size_ = 0;
+    }
+
+    // 인라인(N > 0) 변형의 이동 경로: other의 살아 있는 원소를 순서대로 이동
+    void moveElementsFrom(CircularBuffer& other) {
+        for (std::size_t i = 0; i < other.size_; ++i)
+            emplace_back(std::move(other.data()[other.wrap(other.head_ + i)]));
+        other.destroyAll();
+        other.head_ = other.tail_ = 0;
+    }
+
+    std::size_t head_;  // front
+    std::size_t tail_;  // next write
+    std::size_t size_;
+
+    // 계측 카운터 (이동 시 옮기지 않고 새로 시작한다).
+    // 이 클래스는 외부 동기화가 계약이라 비-atomic 판을 쓴다.
+    instr::LocalCounter    pushes_;
+    instr::LocalCounter    pops_;
+    instr::LocalCounter    overwrites_;
+    instr::LocalMaxTracker occupancyHwm_;
+};
+// ===================== end CircularBuffer =====================
+
+// ==================== SpscCircularBuffer ======================
+// 단일 생산자 / 단일 소비자(SPSC) 전용 락프리 링버퍼.
+// - head_/tail_는 무한 증가 카운터(래핑은 인덱싱 시 % cap_)라서
+//   full/empty 판별에 여분 슬롯이 필요 없다.
+// - acquire/release 순서만으로 생산자↔소비자 가시성을 보장하므로
+//   외부 mutex 없이 양쪽 모두 wait-free로 동작한다.
+// - alignas(64)로 두 카운터를 다른 캐시라인에 배치(false sharing 방지).
+// 주의: CircularBuffer와 달리 가득 찼을 때 덮어쓰기가 불가능하다
+//       (소비자가 읽는 중인 슬롯을 건드리게 됨). push_back은 대신
+//       false를 반환하고, pop_front도 빈 버퍼에서 false를 반환한다.
+template <typename T>
+class SpscCircularBuffer {
+public:
+    explicit SpscCircularBuffer(std::size_t capacity)
+        : cap_(capacity), mask_((capacity & (capacity - 1)) == 0 ? capacity - 1 : 0),
+          data_(std::make_unique<T[]>(capacity)) {
+        if (cap_ == 0) throw std::invalid_argument("capacity must be > 0");
+    }
+
+    // 생산자 스레드 전용. 가득 차 있으면 false.
+    bool push_back(const T& item) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == cap_) return false;
+        data_[wrap(tail)] = item;
+        tail_.store(tail + 1, std::memory_order_release); // 쓰기 완료 후 공개
+        return true;
+    }
+
+    // 소비자 스레드 전용. 비어 있으면 false.
+    bool pop_front() {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head) return false;
+        head_.store(head + 1, std::memory_order_release); // 슬롯 반납 공개
+        return true;
+    }
+
+    // 소비자 스레드 전용. CircularBuffer::front()와 동일하게 빈 버퍼면 예외.
+    T& front() {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_.load(std::memory_order_acquire) == head)
+            throw std::out_of_range("front on empty");
+        return data_[wrap(head)];
+    }
+
+    // 아래 셋은 어느 쪽 스레드에서 불러도 안전한 근사 스냅샷이다.
+    std::size_t size() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    std::size_t capacity() const noexcept { return cap_; }
+    bool        empty()    const noexcept { return size() == 0; }
+
+private:
+    // 무한 증가 카운터에도 비트마스크 래핑은 그대로 성립한다 (2^k 용량일 때).
+    std::size_t wrap(std::size_t i) const noexcept { return mask_ ? (i & mask_) : (i % cap_); }
+
+    std::size_t cap_;
+    std::size_t mask_; // cap_가 2^k이면 cap_-1, 아니면 0
+    std::unique_ptr<T[]> data_;
+    alignas(64) std::atomic<std::size_t> head_{0}; // 소비자 위치
+    alignas(64) std::atomic<std::size_t> tail_{0}; // 생산자 위치
+};
+// ================== end SpscCircularBuffer ====================
+
+// ==================== MpmcCircularQueue =======================
+// 다중 생산자 / 다중 소비자(MPMC) 유계 큐. Dmitry Vyukov의
+// 슬롯별 시퀀스 번호 설계를 따른다:
+// - 각 슬롯이 자기 시퀀스 번호(seq)를 들고 있어, 생산자/소비자는
+//   seq와 자신의 티켓(pos)을 비교해 슬롯 소유권을 CAS 한 번으로 얻는다.
+// - mutex/condvar 없이 여러 획득 스레드가 여러 워커에게 작업을 넘길 수 있다.
+// - 용량 의미는 CircularBuffer와 동일 (0이면 예외, 2^k이면 비트마스크 래핑).
+// try_push/try_pop은 즉시 반환(논블로킹), push/pop은 yield 스핀(블로킹).
+template <typename T>
+class MpmcCircularQueue {
+public:
+    explicit MpmcCircularQueue(std::size_t capacity)
+        : cap_(capacity), mask_((capacity & (capacity - 1)) == 0 ? capacity - 1 : 0),
+          slots_(std::make_unique<Slot[]>(capacity)) {
+        if (cap_ == 0) throw std::invalid_argument("capacity must be > 0");
+        for (std::size_t i = 0; i < cap_; ++i)
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // 가득 차 있으면 false (논블로킹). rvalue는 슬롯으로 이동하므로
+    // T가 std::string처럼 힙을 끄는 타입이어도 큐 경계에서 복사가 없다.
+    bool try_push(const T& item) { return tryPushImpl(item); }
+    bool try_push(T&& item)      { return tryPushImpl(std::move(item)); }
+
+    // 비어 있으면 false (논블로킹).
+    bool try_pop(T& out) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[wrap(pos)];
+            const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (dif == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(slot.value);
+                    slot.seq.store(pos + cap_, std::memory_order_release); // 다음 바퀴용 반납
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false; // 아직 생산되지 않음 = empty
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 블로킹 변형: 자리가 날 때까지 yield 스핀.
+    void push(const T& item) { while (!try_push(item)) std::this_thread::yield(); }
+    void push(T&& item)      { while (!try_push(std::move(item))) std::this_thread::yield(); }
+    void pop(T& out)         { while (!try_pop(out))   std::this_thread::yield(); }
+
+    // 근사 스냅샷 (경쟁 중에는 순간값).
+    std::size_t size() const noexcept {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : 0;
+    }
+    std::size_t capacity() const noexcept { return cap_; }
+    bool        empty()    const noexcept { return size() == 0; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> seq{0};
+        T value{};
+    };
+
+    // 공용 구현: 성공한 경우에만 item을 소비한다 (lvalue 복사 / rvalue 이동)
+    template <typename U>
+    bool tryPushImpl(U&& item) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[wrap(pos)];
+            const std::size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (dif == 0) {
+                // 슬롯이 비어 있고 내 차례 → 티켓 선점 시도
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::forward<U>(item);
+                    slot.seq.store(pos + 1, std::memory_order_release); // 소비 가능 공개
+                    return true;
+                }
+            } else if (dif < 0) {
+                return false; // 한 바퀴 전 값이 아직 소비되지 않음 = full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed); // 다른 생산자가 앞서감
+            }
+        }
+    }
+
+    std::size_t wrap(std::size_t i) const noexcept { return mask_ ? (i & mask_) : (i % cap_); }
+
+    std::size_t cap_;
+    std::size_t mask_; // cap_가 2^k이면 cap_-1, 아니면 0
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<std::size_t> head_{0}; // 소비 티켓
+    alignas(64) std::atomic<std::size_t> tail_{0}; // 생산 티켓
+};
+// ================== end MpmcCircularQueue =====================
@@ -0,0 +1,156 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// ======================= Instrumentation =======================
+// 세 컴포넌트 공용 핫패스 계측 프리미티브.
+// - Counter      : relaxed atomic 누적 카운터
+// - MaxTracker   : relaxed CAS로 유지하는 최대값(high-water mark)
+// - LocalCounter / LocalMaxTracker: 위 둘의 비-atomic 판. 외부 동기화가
+//   계약인 클래스(CircularBuffer 등)용 — 그 계약이 카운터도 보호하므로
+//   핫패스에 atomic RMW를 낼 이유가 없다.
+// - Log2Histogram: 지연시간(ns)을 floor(log2)+1 버킷에 담는 히스토그램.
+//                  record가 fetch_add 한 번이라 핫패스에 넣어도 싸다.
+// 전부 relaxed인 이유: 순서 보장이 필요 없는 단순 집계이고, 스냅샷을
+// 읽는 쪽도 근사값이면 충분하기 때문이다.
+//
+// 기본 활성. -DINSTR_ENABLED=0 으로 빌드하면 모든 프리미티브가 빈
+// no-op 타입으로 바뀌어 계측 코드(시각 읽기 포함)가 통째로 컴파일 아웃된다.
+#ifndef INSTR_ENABLED
+#define INSTR_ENABLED 1
+#endif
+
+namespace instr {
+
+#if INSTR_ENABLED
+
+inline std::uint64_t nowNs() noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+class Counter {
+public:
+    void add(std::uint64_t n = 1) noexcept { v_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t get() const noexcept { return v_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<std::uint64_t> v_{0};
+};
+
+class MaxTracker {
+public:
+    void observe(std::uint64_t v) noexcept {
+        std::uint64_t cur = v_.load(std::memory_order_relaxed);
+        while (v > cur && !v_.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+        }
+    }
+    std::uint64_t get() const noexcept { return v_.load(std::memory_order_relaxed); }
+private:
+    std::atomic<std::uint64_t> v_{0};
+};
+
+class LocalCounter {
+public:
+    void add(std::uint64_t n = 1) noexcept { v_ += n; }
+    std::uint64_t get() const noexcept { return v_; }
+private:
+    std::uint64_t v_ = 0;
+};
+
+class LocalMaxTracker {
+public:
+    void observe(std::uint64_t v) noexcept { if (v > v_) v_ = v; }
+    std::uint64_t get() const noexcept { return v_; }
+private:
+    std::uint64_t v_ = 0;
+};
+
+class Log2Histogram {
+public:
+    void record(std::uint64_t v) noexcept {
+        buckets_[bucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const noexcept {
+        std::uint64_t total = 0;
+        for (const auto& b : buckets_) total += b.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // q 분위수가 속한 버킷의 상한(ns)을 돌려준다 (버킷 단위 근사).
+    // 표본이 없으면 0.
+    std::uint64_t percentile(double q) const noexcept {
+        std::array<std::uint64_t, kBuckets> snap{};
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            snap[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += snap[i];
+        }
+        if (total == 0) return 0;
+        const auto target =
+            static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += snap[i];
+            if (seen >= target) return upperBound(i);
+        }
+        return upperBound(kBuckets - 1);
+    }
+
+private:
+    static constexpr std::size_t kBuckets = 65; // 버킷 b = 값 범위 [2^(b-1), 2^b)
+
+    static std::size_t bucketOf(std::uint64_t v) noexcept {
+        std::size_t b = 0;
+        while (v) { ++b; v >>= 1; }
+        return b;
+    }
+    static constexpr std::uint64_t upperBound(std::size_t b) noexcept {
+        return b >= 64 ? ~0ull : (std::uint64_t{1} << b);
+    }
+
+    std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+};
+
+#else // INSTR_ENABLED == 0 : 동일 API의 no-op 타입 (상태/코드 없음)
+
+inline constexpr std::uint64_t nowNs() noexcept { return 0; }
+
+class Counter {
+public:
+    void add(std::uint64_t = 1) noexcept {}
+    std::uint64_t get() const noexcept { return 0; }
+};
+
+class MaxTracker {
+public:
+    void observe(std::uint64_t) noexcept {}
+    std::uint64_t get() const noexcept { return 0; }
+};
+
+class LocalCounter {
+public:
+    void add(std::uint64_t = 1) noexcept {}
+    std::uint64_t get() const noexcept { return 0; }
+};
+
+class LocalMaxTracker {
+public:
+    void observe(std::uint64_t) noexcept {}
+    std::uint64_t get() const noexcept { return 0; }
+};
+
+class Log2Histogram {
+public:
+    void record(std::uint64_t) noexcept {}
+    std::uint64_t count() const noexcept { return 0; }
+    std::uint64_t percentile(double) const noexcept { return 0; }
+};
+
+#endif
+
+} // namespace instr
+// ===================== end Instrumentation =====================
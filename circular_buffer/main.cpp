@@ -5,89 +5,10 @@
 #include <algorithm>
 #include <numeric>
 #include <iomanip>
+#include <thread>
 #include <windows.h>
 
-// ======================= CircularBuffer =======================
-template <typename T>
-class CircularBuffer {
-public:
-    explicit CircularBuffer(std::size_t capacity)
-        : cap_(capacity), data_(std::make_unique<T[]>(capacity)),
-          head_(0), tail_(0), size_(0) {
-        if (cap_ == 0) throw std::invalid_argument("capacity must be > 0");
-    }
-
-    void push_back(const T& item) {
-        data_[tail_] = item;
-        if (size_ == cap_) {
-            head_ = (head_ + 1) % cap_; // overwrite 정책(가장 오래된 것 버림)
-        } else {
-            ++size_;
-        }
-        tail_ = (tail_ + 1) % cap_;
-    }
-
-    void pop_front() {
-        if (empty()) throw std::out_of_range("pop_front on empty buffer");
-        head_ = (head_ + 1) % cap_;
-        --size_;
-    }
-
-    T&       front()       { if (empty()) throw std::out_of_range("front on empty"); return data_[head_]; }
-    const T& front() const { if (empty()) throw std::out_of_range("front on empty"); return data_[head_]; }
-
-    T&       back()        { if (empty()) throw std::out_of_range("back on empty");  return data_[(tail_ + cap_ - 1) % cap_]; }
-    const T& back()  const { if (empty()) throw std::out_of_range("back on empty");  return data_[(tail_ + cap_ - 1) % cap_]; }
-
-    std::size_t size()     const noexcept { return size_; }
-    std::size_t capacity() const noexcept { return cap_;  }
-    bool        empty()    const noexcept { return size_ == 0; }
-
-    // ---- STL forward iterator (const/non-const) ----
-    template <bool IsConst>
-    class Iter {
-        using Buf = std::conditional_t<IsConst, const CircularBuffer, CircularBuffer>;
-        using Ref = std::conditional_t<IsConst, const T&, T&>;
-        using Ptr = std::conditional_t<IsConst, const T*, T*>;
-    public:
-        using iterator_category = std::forward_iterator_tag;
-        using value_type        = T;
-        using difference_type   = std::ptrdiff_t;
-        using reference         = Ref;
-        using pointer           = Ptr;
-
-        Iter(Buf* buf, std::size_t idx, std::size_t left) : buf_(buf), idx_(idx), left_(left) {}
-        reference operator*() const { return buf_->data_[idx_]; }
-        pointer   operator->() const { return &buf_->data_[idx_]; }
-        Iter& operator++() { if (left_) { idx_ = (idx_ + 1) % buf_->cap_; --left_; } return *this; }
-        Iter operator++(int) { auto tmp = *this; ++(*this); return tmp; }
-        friend bool operator==(const Iter& a, const Iter& b){ return a.buf_==b.buf_ && a.idx_==b.idx_ && a.left_==b.left_; }
-        friend bool operator!=(const Iter& a, const Iter& b){ return !(a==b); }
-    private:
-        Buf* buf_; std::size_t idx_; std::size_t left_;
-    };
-
-    using iterator       = Iter<false>;
-    using const_iterator = Iter<true>;
-    iterator begin()             { return iterator(this, head_, size_); }
-    iterator end()               { return iterator(this, (head_ + size_) % cap_, 0); }
-    const_iterator begin() const { return cbegin(); }
-    const_iterator end()   const { return cend();   }
-    const_iterator cbegin() const{ return const_iterator(this, head_, size_); }
-    const_iterator cend()   const{ return const_iterator(this, (head_ + size_) % cap_, 0); }
-
-    // 디버깅/출력용: 내부 인덱스 순서(raw order)로 접근
-    T at_index(std::size_t i) const { return data_[i]; } // i는 0..cap_-1
-    std::size_t head_index() const { return head_; }
-
-private:
-    std::size_t cap_;
-    std::unique_ptr<T[]> data_;
-    std::size_t head_;  // front
-    std::size_t tail_;  // next write
-    std::size_t size_;
-};
-// ===================== end CircularBuffer =====================
+#include "CircularBuffer.hpp"
 
 // ---------------------- Demo (요구 예제 출력) ----------------------
 int main() {
@@ -134,7 +55,51 @@ int main() {
     std::cout << "maxTemp = " << std::fixed << std::setprecision(1) << maxTemp << "\n";
     std::cout << "avgTemp = " << std::fixed << std::setprecision(2) << avgTemp << "\n";
 
+    // 위의 max_element + accumulate 2패스를 단일 패스로 대체하는 stats()
+    const auto st = tempBuffer.stats();
+    std::cout << "stats(): min=" << std::fixed << std::setprecision(1) << st.min
+              << " max=" << st.max
+              << " mean=" << std::setprecision(2) << st.mean
+              << " var=" << st.variance << "\n";
+
     std::cout << u8"tempBuffer.front() = " << std::fixed << std::setprecision(1) << tempBuffer.front() << "  // 가장 오래된 데이터\n";
     std::cout << u8"tempBuffer.back()  = " << std::fixed << std::setprecision(1) << tempBuffer.back()  << "  // 가장 최근 데이터\n";
+
+    // 4) SPSC 락프리 버퍼: 센서 스레드 → 소비자 스레드 (mutex 없음)
+    SpscCircularBuffer<double> sensorQueue(1024);
+    const std::size_t kSamples = 100'000;
+
+    std::thread producer([&] {
+        for (std::size_t i = 0; i < kSamples; ++i) {
+            while (!sensorQueue.push_back(20.0 + 0.001 * static_cast<double>(i))) {
+                std::this_thread::yield(); // 가득 참 → 소비자 대기
+            }
+        }
+    });
+
+    double lastSample = 0.0;
+    std::size_t received = 0;
+    std::thread consumer([&] {
+        while (received < kSamples) {
+            if (sensorQueue.empty()) { std::this_thread::yield(); continue; }
+            lastSample = sensorQueue.front();
+            sensorQueue.pop_front();
+            ++received;
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    std::cout << u8"\n// SPSC 락프리 수신 결과\n";
+    std::cout << u8"수신 샘플 수 = " << received << "\n";
+    std::cout << u8"마지막 샘플  = " << std::fixed << std::setprecision(3) << lastSample << "\n";
+
+    // 5) 컴파일타임 용량 변형: 힙 할당 없음, 2^k 래핑이 상수 마스크로 접힘
+    CircularBuffer<int, 8> inlineBuf;
+    for (int i = 0; i < 10; ++i) inlineBuf.push_back(i);
+    std::cout << u8"\n// 인라인(컴파일타임 용량) 버퍼\n";
+    std::cout << "sizeof(inlineBuf) = " << sizeof(inlineBuf) << u8" bytes (힙 할당 0회)\n";
+    std::cout << "front=" << inlineBuf.front() << " back=" << inlineBuf.back() << "\n";
     return 0;
 }
@@ -1,58 +1,365 @@
 #pragma once
-#include <unordered_map>
+#include <array>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
 #include <stdexcept>
 #include <filesystem> // for create_directories
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#include <cstring>     // memchr
+#include <string_view>
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "../circular_buffer/CircularBuffer.hpp" // MpmcCircularQueue (비동기 큐)
+#include "../circular_buffer/Instrumentation.hpp"
+#include "../parallel_processor/ParallelProcessor.hpp" // processLogs의 ParallelProcessor
+
+// 컴파일 타임 최소 심각도. 이 값 미만의 log<S>() 호출은 if constexpr로
+// 본문이 통째로 사라진다 (포맷팅도, 타임스탬프도, 분기도 없음).
+// 빌드 시 -DLOGFILE_MIN_SEVERITY=2 식으로 올릴 수 있다 (0=Debug ... 3=Error).
+#ifndef LOGFILE_MIN_SEVERITY
+#define LOGFILE_MIN_SEVERITY 0
+#endif
+
+// ======================= MappedLogFile ========================
+// readLogs의 줄당 힙 할당(getline → vector<string>) 대신 파일을 통째로
+// 메모리 맵으로 열고, 줄을 매핑 위의 string_view로 돌려준다.
+// 이 객체가 살아 있는 동안만 뷰가 유효하다(소유 핸들).
+// - lines()      : 전체 줄 인덱스를 한 번에 만든다 (뷰 벡터, 내용 복사 없음)
+// - begin()/end(): 인덱스조차 만들지 않고 스트리밍 순회 (memchr 기반)
+class MappedLogFile {
+public:
+    explicit MappedLogFile(const std::string& fullpath) {
+#if defined(_WIN32)
+        file_ = CreateFileA(fullpath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Failed to open file for mapping: " + fullpath);
+        }
+        LARGE_INTEGER fileSize{};
+        GetFileSizeEx(file_, &fileSize);
+        size_ = static_cast<std::size_t>(fileSize.QuadPart);
+        if (size_ != 0) {
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_) {
+                CloseHandle(file_);
+                throw std::runtime_error("CreateFileMapping failed: " + fullpath);
+            }
+            data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            if (!data_) {
+                CloseHandle(mapping_);
+                CloseHandle(file_);
+                throw std::runtime_error("MapViewOfFile failed: " + fullpath);
+            }
+        }
+#else
+        fd_ = ::open(fullpath.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            throw std::runtime_error("Failed to open file for mapping: " + fullpath);
+        }
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("fstat failed: " + fullpath);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ != 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("mmap failed: " + fullpath);
+            }
+            data_ = static_cast<const char*>(p);
+        }
+#endif
+    }
+
+    // 매핑 수명 관리상 복사는 금지, 이동은 허용 (mapLogs가 값으로 반환)
+    MappedLogFile(const MappedLogFile&)            = delete;
+    MappedLogFile& operator=(const MappedLogFile&) = delete;
+    MappedLogFile(MappedLogFile&& other) noexcept { swap(other); }
+    MappedLogFile& operator=(MappedLogFile&& other) noexcept {
+        if (this != &other) { release(); swap(other); }
+        return *this;
+    }
+
+    ~MappedLogFile() { release(); }
+
+    std::string_view contents() const noexcept { return { data_, size_ }; }
+    std::size_t      size_bytes() const noexcept { return size_; }
+
+    // ---- 스트리밍 줄 반복자 (인덱스 없이 순회) ----
+    class LineIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = const std::string_view&;
+        using pointer           = const std::string_view*;
+
+        LineIterator() = default; // end
+        explicit LineIterator(std::string_view rest) : rest_(rest), done_(rest.empty()) {
+            if (!done_) advance();
+        }
+        reference operator*()  const { return line_; }
+        pointer   operator->() const { return &line_; }
+        LineIterator& operator++() {
+            if (rest_.empty()) done_ = true;
+            else advance();
+            return *this;
+        }
+        LineIterator operator++(int) { auto tmp = *this; ++(*this); return tmp; }
+        friend bool operator==(const LineIterator& a, const LineIterator& b) {
+            return a.done_ == b.done_ && (a.done_ || a.rest_.data() == b.rest_.data());
+        }
+        friend bool operator!=(const LineIterator& a, const LineIterator& b) { return !(a == b); }
+    private:
+        void advance() {
+            const char* p = static_cast<const char*>(
+                std::memchr(rest_.data(), '\n', rest_.size()));
+            if (p) {
+                const auto len = static_cast<std::size_t>(p - rest_.data());
+                line_ = rest_.substr(0, len);
+                rest_.remove_prefix(len + 1);
+            } else { // 개행 없는 마지막 줄
+                line_ = rest_;
+                rest_ = std::string_view{};
+            }
+        }
+        std::string_view rest_;
+        std::string_view line_;
+        bool done_ = true;
+    };
+
+    LineIterator begin() const { return LineIterator(contents()); }
+    LineIterator end()   const { return LineIterator(); }
+
+    // 전체 줄 인덱스 (readLogs와 같은 줄 분할, 단 내용 복사 없음)
+    std::vector<std::string_view> lines() const {
+        std::vector<std::string_view> result;
+        for (auto it = begin(); it != end(); ++it) result.push_back(*it);
+        return result;
+    }
+
+private:
+    void release() noexcept {
+#if defined(_WIN32)
+        if (data_)    UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        data_ = nullptr; mapping_ = nullptr; file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+        data_ = nullptr; fd_ = -1;
+#endif
+        size_ = 0;
+    }
+    void swap(MappedLogFile& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#if defined(_WIN32)
+        std::swap(file_, other.file_);
+        std::swap(mapping_, other.mapping_);
+#else
+        std::swap(fd_, other.fd_);
+#endif
+    }
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    HANDLE file_    = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+// ===================== end MappedLogFile ======================
 
 class LogFileManager {
 public:
-    LogFileManager() = default;
+    // 기록 모드:
+    // - Sync : writeLog가 호출자 스레드에서 바로 스트림에 쓴다.
+    //          (flush는 이제 호출자가 flush()로 명시 — 메시지당 flush 제거)
+    // - Async: writeLog는 완성된 한 줄을 인메모리 MPMC 링버퍼 큐에 넣고 즉시
+    //          반환하고, 백그라운드 writer 스레드가 배치로 모아 쓴 뒤
+    //          배치당 한 번만 flush한다. 큐가 가득 차면 배압(블로킹 push).
+    //
+    // 스레드 안전성: 파일 핸들 맵은 kShards개 샤드로 나뉘고 샤드별 mutex로
+    // 보호된다. 조회는 string_view 이종(heterogeneous) find라서 호출마다
+    // makePath 문자열을 만들지 않으며, 샤드 락은 조회 동안만 잡는다.
+    // 실제 스트림 기록은 파일 항목별 mutex로 직렬화되므로, 서로 다른
+    // 파일에 쓰는 스레드끼리는 전혀 경합하지 않는다. (Async 큐는 MPMC라
+    // 여러 스레드가 동시에 writeLog를 불러도 된다.)
+    enum class Mode { Sync, Async };
+
+    // 레코드 포맷:
+    // - Text  : "[타임스탬프] 메시지" 한 줄 (기본, 기존 동작)
+    // - Binary: 고정 리틀엔디언 헤더(ticks 8B + 심각도 1B + 길이 4B) 뒤에
+    //   메시지 바이트. 타임스탬프 포맷팅이 기록 경로에서 사라지고,
+    //   읽기도 getline 파싱 대신 고정 크기 헤더 단위로 진행된다.
+    //   exportBinaryLogs()가 필요할 때 텍스트 포맷으로 렌더링한다.
+    enum class Format { Text, Binary };
+
+    // 심각도 레벨. 배열 인덱스로 바로 쓰인다.
+    enum class Severity : unsigned char { Debug = 0, Info = 1, Warning = 2, Error = 3 };
+    static constexpr std::size_t kSeverityCount = 4;
+    static constexpr Severity kMinSeverity = static_cast<Severity>(LOGFILE_MIN_SEVERITY);
+
+    // 그룹 커밋 flush 정책.
+    // 기본(정책 미설정)은 기존 동작: Async writer가 배치당 1회 flush,
+    // Sync는 명시적 flush()만. 정책을 설정하면 대신:
+    //   - maxBytes  : 파일별 미flush 바이트가 이 값에 도달하면 flush
+    //   - maxDelay  : 마지막 flush 후 이 시간이 지나면 flush (writer가 주기 검사)
+    //   - immediate : 이 심각도 이상 레코드는 기록 직후 바로 flush
+    // 예: {.maxBytes=64*1024, .maxDelay=1s, .immediate=Error} →
+    //     에러는 수 ms 내 디스크에, 나머지는 1초 내, flush 횟수는 ~1/100.
+    struct FlushPolicy {
+        std::size_t               maxBytes = 0;                  // 0 = 바이트 기준 없음
+        std::chrono::milliseconds maxDelay{0};                   // 0 = 시간 기준 없음
+        Severity                  immediate = Severity::Error;
+        bool                      useImmediate = true;
+    };
+
+    // 설정 단계에서 호출하고, 이후 로깅과 동시에 바꾸지 않는 사용을 전제한다.
+    void setFlushPolicy(const FlushPolicy& policy) {
+        policy_ = policy;
+        policyActive_ = policy.maxBytes != 0 || policy.maxDelay.count() != 0 || policy.useImmediate;
+    }
+
+    // 크기 기반 로테이션 한도 설정 (0 = 로테이션 없음, 기본값).
+    // 파일이 maxBytes에 도달하면 rename 후 미리 만들어 둔 빈 파일로 즉시
+    // 교체하므로, 쓰기 버스트 중에 생성/확장으로 블로킹하지 않는다.
+    // 기록량은 메모리 카운터로 추적한다 (tellp() 호출 없음).
+    void setMaxFileSize(std::size_t maxBytes) {
+        maxFileSize_.store(maxBytes, std::memory_order_relaxed);
+    }
+
+    explicit LogFileManager(Mode mode = Mode::Sync, Format format = Format::Text)
+        : mode_(mode), format_(format) {
+        if (mode_ == Mode::Async) {
+            queue_ = std::make_unique<MpmcCircularQueue<LogRecord>>(kQueueCapacity);
+            writer_ = std::thread([this] { writerLoop(); });
+        }
+    }
 
-    // 파일 핸들 관리 특성상 복사는 금지, 이동은 허용
+    // 파일 핸들 + 백그라운드 스레드 특성상 복사/이동 모두 금지
     LogFileManager(const LogFileManager&)            = delete;
     LogFileManager& operator=(const LogFileManager&) = delete;
-    LogFileManager(LogFileManager&&) noexcept        = default;
-    LogFileManager& operator=(LogFileManager&&) noexcept = default;
 
-    ~LogFileManager() { closeAll(); }
+    ~LogFileManager() {
+        if (mode_ == Mode::Async) {
+            stop_.store(true, std::memory_order_release);
+            writer_.join(); // 종료 전에 큐를 끝까지 비운다
+        }
+        closeAll();
+    }
 
     // logs/ 폴더에 파일을 연다 (없으면 폴더 생성)
     void openLogFile(const std::string& filename) {
         std::filesystem::create_directories("logs");
-        const std::string fullpath = makePath(filename);
 
-        if (writers_.find(fullpath) != writers_.end()) return;
+        Shard& shard = shardOf(filename);
+        std::lock_guard<std::mutex> lk(shard.mx);
+        if (shard.files.find(filename) != shard.files.end()) return;
 
-        auto ofs = std::make_unique<std::ofstream>();
-        ofs->open(fullpath, std::ios::out | std::ios::app);
-        if (!ofs->is_open()) {
+        const std::string fullpath = makePath(filename);
+        auto entry = std::make_unique<FileEntry>();
+        entry->fullpath = fullpath;
+        entry->out.open(fullpath, openFlags());
+        if (!entry->out.is_open()) {
             throw std::runtime_error("Failed to open file: " + fullpath);
         }
-        writers_.emplace(fullpath, std::move(ofs));
+        // append 모드로 이어 쓰는 기존 파일 크기를 카운터 시작값으로
+        std::error_code ec;
+        const auto existing = std::filesystem::file_size(fullpath, ec);
+        entry->bytesWritten = ec ? 0 : static_cast<std::size_t>(existing);
+        if (maxFileSize_.load(std::memory_order_relaxed) != 0) prepareSpare(*entry);
+        shard.files.emplace(filename, std::move(entry));
     }
 
-    // 타임스탬프를 붙여 기록
-    void writeLog(const std::string& filename, const std::string& message) {
-        const std::string fullpath = makePath(filename);
-        auto it = writers_.find(fullpath);
-        if (it == writers_.end()) {
-            throw std::runtime_error("File is not open: " + fullpath);
+    // 타임스탬프를 붙여 기록.
+    // Sync 모드: 바로 쓴다(메시지당 flush는 하지 않음 — 필요 시 flush() 호출).
+    // Async 모드: 큐에 넣고 즉시 반환. 디스크 I/O는 writer 스레드가 담당.
+    // 두 인자 모두 string_view라서 호출자가 std::string을 만들 필요가 없다.
+    void writeLog(std::string_view filename, std::string_view message) {
+        deliver(findEntryOrThrow(filename), buildRecord(message));
+    }
+
+    // 리터럴/char* 호출이 string_view와 rvalue 오버로드 사이에서 모호해지지
+    // 않도록 명시적으로 받아 넘긴다
+    void writeLog(std::string_view filename, const char* message) {
+        writeLog(filename, std::string_view(message));
+    }
+
+    // rvalue 버전: 메시지 버퍼를 그대로 레코드로 재사용한다 (타임스탬프/헤더를
+    // 앞쪽에 삽입만 하고 새 문자열을 만들지 않음). 비동기 큐에도 move로 들어간다.
+    void writeLog(std::string_view filename, std::string&& message) {
+        deliver(findEntryOrThrow(filename), buildRecord(std::move(message)));
+    }
+
+    // printf 스타일 포맷 버전: 스레드별 재사용 버퍼에 직접 포맷하므로
+    // 호출마다 포맷용 힙 할당이 없다.
+    template <typename... Args>
+    void writeLogf(std::string_view filename, const char* fmt, Args&&... args) {
+        static thread_local std::vector<char> buf(256);
+        int needed = std::snprintf(buf.data(), buf.size(), fmt, args...);
+        if (needed < 0) {
+            throw std::runtime_error("writeLogf: format error");
         }
-        std::ofstream& out = *(it->second);
-        if (!out.good()) {
-            throw std::runtime_error("Bad output stream: " + fullpath);
+        if (static_cast<std::size_t>(needed) >= buf.size()) {
+            buf.resize(static_cast<std::size_t>(needed) + 1);
+            needed = std::snprintf(buf.data(), buf.size(), fmt, args...);
         }
-        out << "[" << nowTimestamp() << "] " << message << '\n';
-        out.flush();
-        if (!out.good()) {
-            throw std::runtime_error("Write/flush failed: " + fullpath);
+        writeLog(filename, std::string_view(buf.data(), static_cast<std::size_t>(needed)));
+    }
+
+    // ---- 핫패스 계측 스냅샷 ----
+    // -DINSTR_ENABLED=0이면 전부 0이 나온다 (계측 코드 컴파일 아웃).
+    struct PerfStats {
+        std::uint64_t enqueued;        // 비동기 큐에 들어간 레코드 수
+        std::uint64_t queue_depth_hwm; // 관측된 최대 큐 깊이
+        std::uint64_t flushes;         // out.flush() 호출 수
+        std::uint64_t flush_p50_ns;    // flush 지연 분위수 (log2 버킷 상한)
+        std::uint64_t flush_p95_ns;
+        std::uint64_t write_errors;    // 비동기 writer가 버린 레코드/실패한 기록 수
+    };
+    PerfStats perf_stats() const noexcept {
+        return { enqueued_.get(), queueDepthHwm_.get(), flushes_.get(),
+                 flushHist_.percentile(0.5), flushHist_.percentile(0.95),
+                 writeErrors_.get() };
+    }
+
+    // 지금까지 기록 요청된 모든 로그가 디스크에 닿도록 보장한다.
+    // Async 모드에서는 먼저 큐가 비워질 때까지 기다린다.
+    void flush() {
+        if (mode_ == Mode::Async) {
+            while (outstanding_.load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
         }
+        forEachEntry([this](FileEntry& entry) {
+            std::lock_guard<std::mutex> lk(entry.mx);
+            timedFlush(entry);
+        });
     }
 
     // 파일 전체를 줄 단위로 읽어 반환
@@ -73,38 +380,510 @@ public:
         return lines;
     }
 
-    // 개별 파일 닫기
-    void closeLogFile(const std::string& filename) {
+    // 심각도 → 파일 라우팅. 한 번 등록해 두면 log()는 해시/맵 조회 없이
+    // 배열 인덱스로 파일 항목에 바로 간다. (등록은 설정 단계에서 끝내고,
+    // 이후 log() 호출과 동시에 바꾸지 않는 사용을 전제한다.)
+    void routeSeverity(Severity s, std::string_view filename) {
+        severityRoutes_[static_cast<std::size_t>(s)] = findEntryOrThrow(filename);
+    }
+
+    // 컴파일 타임 심각도 버전: S < kMinSeverity면 본문이 통째로 제거된다.
+    template <Severity S>
+    void log(std::string_view message) {
+        if constexpr (static_cast<int>(S) < static_cast<int>(kMinSeverity)) {
+            (void)message; // 비활성 레벨: 코드 생성 없음
+        } else {
+            logAt(S, message);
+        }
+    }
+
+    // 런타임 심각도 버전 (동적 레벨용)
+    void log(Severity s, std::string_view message) {
+        if (static_cast<int>(s) < static_cast<int>(kMinSeverity)) return;
+        logAt(s, message);
+    }
+
+    // 파일별 인메모리 테일 활성화: 최근 capacity개 줄을 writeLog 시점에
+    // CircularBuffer<std::string>으로 보관한다. 활성화 이후의 기록만 담긴다.
+    // setFlushPolicy/routeSeverity와 마찬가지로 설정 단계에서 호출하고,
+    // 해당 파일에 로깅이 진행되는 동안에는 바꾸지 않는 사용을 전제한다
+    // (deliver가 tail 포인터를 락 없이 읽는 근거).
+    void enableTail(const std::string& filename, std::size_t capacity) {
+        FileEntry* entry = findEntry(filename);
+        if (!entry) {
+            throw std::runtime_error("File is not open: " + makePath(filename));
+        }
+        std::lock_guard<std::mutex> lk(entry->mx);
+        entry->tail = std::make_unique<CircularBuffer<std::string>>(capacity);
+    }
+
+    // 최근 n줄(오래된 → 최신)을 RAM에서 바로 반환한다. 파일 재읽기 없음 —
+    // "마지막 100줄" 폴링이 수 GB 파일 스캔 대신 마이크로초에 끝난다.
+    std::vector<std::string> tailLogs(const std::string& filename, std::size_t n) const {
+        FileEntry* entry = findEntry(filename);
+        if (!entry) {
+            throw std::runtime_error("File is not open: " + makePath(filename));
+        }
+        std::lock_guard<std::mutex> lk(entry->mx);
+        if (!entry->tail) {
+            throw std::runtime_error("Tail not enabled: " + makePath(filename));
+        }
+        const std::size_t count = std::min(n, entry->tail->size());
+        std::vector<std::string> lines;
+        lines.reserve(count);
+        for (auto it = entry->tail->end() - static_cast<std::ptrdiff_t>(count);
+             it != entry->tail->end(); ++it) {
+            lines.push_back(*it);
+        }
+        return lines;
+    }
+
+    // Binary 포맷 파일을 현재 텍스트 포맷("[타임스탬프] 메시지")으로 렌더링.
+    // 고정 크기 헤더를 순차로 읽으므로 getline 재파싱이 없다.
+    std::vector<std::string> exportBinaryLogs(const std::string& filename) const {
         const std::string fullpath = makePath(filename);
-        auto it = writers_.find(fullpath);
-        if (it != writers_.end()) {
-            writers_.erase(it); // unique_ptr 파괴 → 파일 자동 close
+        std::ifstream in(fullpath, std::ios::binary);
+        if (!in.is_open()) {
+            throw std::runtime_error("Failed to open file for read: " + fullpath);
+        }
+        std::vector<std::string> lines;
+        char header[kBinaryHeaderSize];
+        while (in.read(header, static_cast<std::streamsize>(kBinaryHeaderSize))) {
+            const auto ticks = static_cast<std::chrono::system_clock::rep>(
+                readLittleEndian(header, 8));
+            const auto len = static_cast<std::size_t>(readLittleEndian(header + 9, 4));
+            std::string message(len, '\0');
+            if (len != 0 && !in.read(&message[0], static_cast<std::streamsize>(len))) {
+                throw std::runtime_error("Truncated binary record: " + fullpath);
+            }
+            std::string rendered;
+            rendered.reserve(message.size() + 24);
+            rendered += '[';
+            rendered += formatTicks(ticks);
+            rendered += "] ";
+            rendered += message;
+            lines.push_back(std::move(rendered));
+        }
+        return lines;
+    }
+
+    // mmap 기반 읽기: 파일을 복사 없이 매핑해 string_view 줄 뷰로 접근.
+    // 반환된 MappedLogFile이 살아 있는 동안만 뷰가 유효하다.
+    MappedLogFile mapLogs(const std::string& filename) const {
+        return MappedLogFile(makePath(filename));
+    }
+
+    // 파일을 mmap으로 매핑한 뒤 개행 경계에 맞춘 바이트 구간으로 나눠
+    // pool의 워커들이 동시에 줄 단위로 처리한다. 각 워커는 자기 구간
+    // "안에서 시작하는" 줄만 맡는다: 구간 중간에서 시작하면 다음 줄
+    // 시작까지 전진하고, 마지막 줄은 구간 끝을 넘어 줄 끝까지 읽는다.
+    // 그래서 모든 줄이 정확히 한 번씩, 잘리지 않은 채로 전달된다.
+    // line_func(std::string_view)는 여러 워커에서 동시에 불리므로 스레드
+    // 안전해야 하며, 뷰는 호출 동안만 유효하다. 처리한 줄 수를 반환.
+    template <typename LineFunc>
+    std::size_t processLogs(const std::string& filename,
+                            const ParallelProcessor<char>& pool,
+                            LineFunc line_func) {
+        flush(); // 쓰기 버퍼에 남은 내용까지 보이게
+        const MappedLogFile mapped = mapLogs(filename);
+        const std::string_view all = mapped.contents();
+        const char* base = all.data();
+        const std::size_t total = all.size();
+        if (total == 0) return 0;
+
+        std::atomic<std::size_t> lineCount{0};
+        pool.parallel_blocks(total, [&](std::size_t start, std::size_t end) {
+            std::size_t pos = start;
+            if (pos != 0 && base[pos - 1] != '\n') {
+                // 구간 중간에서 시작: 이 줄은 이전 구간 담당
+                const void* nl = std::memchr(base + pos, '\n', end - pos);
+                if (!nl) return; // 구간 전체가 한 줄의 중간
+                pos = static_cast<std::size_t>(static_cast<const char*>(nl) - base) + 1;
+            }
+            std::size_t local = 0;
+            while (pos < end) {
+                const void* nl = std::memchr(base + pos, '\n', total - pos);
+                const std::size_t lineEnd =
+                    nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - base) : total;
+                line_func(std::string_view(base + pos, lineEnd - pos));
+                ++local;
+                pos = lineEnd + 1;
+            }
+            lineCount.fetch_add(local, std::memory_order_relaxed);
+        });
+        return lineCount.load(std::memory_order_relaxed);
+    }
+
+    // 개별 파일 닫기 (Async 모드면 대기 중인 기록을 먼저 밀어낸다).
+    // 닫는 파일에 동시에 writeLog 중이면 안 된다 (호출자 책임).
+    void closeLogFile(const std::string& filename) {
+        if (mode_ == Mode::Async) flush();
+        Shard& shard = shardOf(filename);
+        std::lock_guard<std::mutex> lk(shard.mx);
+        auto it = shard.files.find(filename);
+        if (it != shard.files.end()) {
+            shard.files.erase(it); // unique_ptr 파괴 → 파일 자동 close
         }
     }
 
 private:
-    std::unordered_map<std::string, std::unique_ptr<std::ofstream>> writers_;
+    // 파일 하나의 핸들 + 기록 직렬화용 mutex + 로테이션 상태
+    struct FileEntry {
+        std::ofstream out;
+        std::mutex    mx;
+        std::string   fullpath;
+        std::size_t   bytesWritten = 0; // tellp() 대신 메모리에서 추적
+        std::size_t   rotations    = 0;
+        std::unique_ptr<CircularBuffer<std::string>> tail; // enableTail 시 최근 K줄
+        std::size_t   pendingBytes = 0; // 마지막 flush 이후 기록된 바이트
+        std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+    };
+
+    // 샤드: 파일명 해시로 분산된 부분 맵. std::less<>라서 string_view로
+    // 이종 find가 가능하다 (호출마다 키 문자열 할당 없음).
+    struct Shard {
+        std::mutex mx;
+        std::map<std::string, std::unique_ptr<FileEntry>, std::less<>> files;
+    };
+    static constexpr std::size_t kShards = 16;
+
+    // 비동기 큐에 들어가는 레코드: 대상 파일 항목 + 완성된 한 줄 + 심각도
+    struct LogRecord {
+        FileEntry*    entry = nullptr;
+        std::string   text;
+        unsigned char severity = 0;
+    };
+    static constexpr std::size_t kQueueCapacity = 8192; // 2^k → 비트마스크 래핑
+    static constexpr std::size_t kBatchMax      = 256;  // flush 1회당 최대 레코드 수
+
+    // writer 스레드: 큐를 배치 단위로 비우고, 배치에서 건드린 스트림만
+    // 배치당 한 번 flush한다. stop_ 신호 후에도 남은 레코드는 모두 쓴다.
+    void writerLoop() {
+        std::vector<FileEntry*> touched;
+        LogRecord rec;
+        for (;;) {
+            touched.clear();
+            std::size_t drained = 0;
+            while (drained < kBatchMax && queue_->try_pop(rec)) {
+                // 오류 계약: 동기 경로는 호출자에게 던지지만, 백그라운드
+                // 워커에서 새는 예외는 terminate로 직행한다. 그래서 여기는
+                // 절대 던지지 않는다 — 실패한 레코드는 버리고 write_errors
+                // 카운터로만 드러낸다 (perf_stats()로 관측).
+                try {
+                    std::lock_guard<std::mutex> lk(rec.entry->mx); // flush()와의 경합 방지
+                    rec.entry->out << rec.text;
+                    if (!rec.entry->out.good()) { // 동기 경로의 good() 검사와 같은 기준
+                        rec.entry->out.clear();   // 스트림을 되살려 다음 레코드는 시도
+                        writeErrors_.add();
+                    }
+                    rec.entry->bytesWritten += rec.text.size();
+                    rec.entry->pendingBytes += rec.text.size();
+                    maybeRotate(*rec.entry); // 재오픈 실패 시 던질 수 있음
+                    applyFlushPolicy(*rec.entry, rec.severity);
+                } catch (...) {
+                    writeErrors_.add();
+                }
+                if (std::find(touched.begin(), touched.end(), rec.entry) == touched.end()) {
+                    touched.push_back(rec.entry);
+                }
+                outstanding_.fetch_sub(1, std::memory_order_release);
+                ++drained;
+            }
+            if (!policyActive_) {
+                // 정책 미설정: 배치에서 건드린 스트림만 배치당 1회 flush
+                for (auto* entry : touched) {
+                    std::lock_guard<std::mutex> lk(entry->mx);
+                    timedFlush(*entry);
+                }
+            }
+            if (drained == 0) {
+                if (stop_.load(std::memory_order_acquire)) return;
+                // maxDelay 기한이 지난 파일들을 주기적으로 밀어낸다
+                if (policyActive_ && policy_.maxDelay.count() != 0) {
+                    forEachEntry([this](FileEntry& entry) {
+                        std::lock_guard<std::mutex> lk(entry.mx);
+                        applyFlushPolicy(entry, 0);
+                    });
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    // ---- 크기 기반 로테이션 ----
+    // entry->mx를 잡은 상태에서 호출된다. 한도 도달 시:
+    //   1) 현재 파일 close 후 "<path>.<n>"으로 rename (아카이브)
+    //   2) 미리 만들어 둔 "<path>.next"를 현재 경로로 rename → 빈 파일로 재개
+    //   3) 다음 로테이션용 spare를 다시 만들어 둔다 (버스트 경로 밖)
+    void maybeRotate(FileEntry& entry) {
+        const std::size_t maxBytes = maxFileSize_.load(std::memory_order_relaxed);
+        if (maxBytes == 0 || entry.bytesWritten < maxBytes) return;
+
+        entry.out.close();
+        std::error_code ec;
+
+        std::string archive;
+        do {
+            archive = entry.fullpath + "." + std::to_string(++entry.rotations);
+        } while (std::filesystem::exists(archive, ec));
+        std::filesystem::rename(entry.fullpath, archive, ec);
+
+        // spare가 있으면 rename 한 번으로 교체, 없으면 새로 만든다
+        std::filesystem::rename(sparePath(entry.fullpath), entry.fullpath, ec);
+        entry.out.open(entry.fullpath, openFlags());
+        if (!entry.out.is_open()) {
+            throw std::runtime_error("Failed to reopen after rotation: " + entry.fullpath);
+        }
+        entry.bytesWritten = 0;
+        prepareSpare(entry);
+    }
+
+    static std::string sparePath(const std::string& fullpath) { return fullpath + ".next"; }
+
+    // 최초 오픈과 로테이션 후 재오픈이 같은 모드를 쓰도록 한 곳에서 계산.
+    // Binary 포맷인데 binary 플래그가 빠지면 Windows에서 0x0A가 CRLF로
+    // 확장되어 레코드 프레이밍이 깨진다.
+    std::ios::openmode openFlags() const {
+        auto flags = std::ios::out | std::ios::app;
+        if (format_ == Format::Binary) flags |= std::ios::binary;
+        return flags;
+    }
+
+    // 다음 로테이션에서 rename만 하면 되도록 빈 파일을 미리 만들어 둔다
+    static void prepareSpare(const FileEntry& entry) {
+        const std::string spare = sparePath(entry.fullpath);
+        std::error_code ec;
+        if (!std::filesystem::exists(spare, ec)) {
+            std::ofstream touch(spare); // 생성만 하고 닫는다
+        }
+    }
+
+    FileEntry* findEntryOrThrow(std::string_view filename) const {
+        FileEntry* entry = findEntry(filename);
+        if (!entry) {
+            throw std::runtime_error("File is not open: " + makePath(filename));
+        }
+        return entry;
+    }
+
+    void logAt(Severity s, std::string_view message) {
+        FileEntry* entry = severityRoutes_[static_cast<std::size_t>(s)];
+        if (!entry) {
+            throw std::runtime_error("Severity not routed (call routeSeverity first)");
+        }
+        deliver(entry, buildRecord(message, static_cast<unsigned char>(s)),
+                static_cast<unsigned char>(s));
+    }
+
+    // message를 현재 포맷의 완성된 레코드 한 건으로 렌더링
+    std::string buildRecord(std::string_view message, unsigned char severity = 0) const {
+        std::string line;
+        if (format_ == Format::Binary) {
+            // ticks(8B LE) + severity(1B, 예약) + length(4B LE) + message
+            const auto ticks = std::chrono::system_clock::now().time_since_epoch().count();
+            line.reserve(kBinaryHeaderSize + message.size());
+            appendLittleEndian(line, static_cast<std::uint64_t>(ticks), 8);
+            line.push_back(static_cast<char>(severity));
+            appendLittleEndian(line, static_cast<std::uint64_t>(message.size()), 4);
+            line += message;
+        } else {
+            line.reserve(message.size() + 24);
+            line += '[';
+            line += nowTimestamp();
+            line += "] ";
+            line += message;
+            line += '\n';
+        }
+        return line;
+    }
 
-    static std::string nowTimestamp() {
+    // rvalue 버전: message의 저장 공간을 레코드로 넘겨받아 재사용한다
+    std::string buildRecord(std::string&& message) const {
+        if (format_ == Format::Binary) {
+            std::string header;
+            header.reserve(kBinaryHeaderSize);
+            const auto ticks = std::chrono::system_clock::now().time_since_epoch().count();
+            appendLittleEndian(header, static_cast<std::uint64_t>(ticks), 8);
+            header.push_back('\0');
+            appendLittleEndian(header, static_cast<std::uint64_t>(message.size()), 4);
+            message.insert(0, header);
+        } else {
+            std::string prefix;
+            prefix.reserve(24);
+            prefix += '[';
+            prefix += nowTimestamp();
+            prefix += "] ";
+            message.insert(0, prefix);
+            message += '\n';
+        }
+        return std::move(message);
+    }
+
+    // entry->mx를 잡은 상태에서 호출. 그룹 커밋 조건을 검사해 필요 시 flush.
+    void applyFlushPolicy(FileEntry& entry, unsigned char severity) {
+        if (!policyActive_) return; // 정책 미설정: 기존 flush 동작 유지
+        bool doFlush = false;
+        if (policy_.useImmediate &&
+            severity >= static_cast<unsigned char>(policy_.immediate)) {
+            doFlush = true;
+        }
+        if (policy_.maxBytes != 0 && entry.pendingBytes >= policy_.maxBytes) {
+            doFlush = true;
+        }
+        if (policy_.maxDelay.count() != 0 && entry.pendingBytes != 0 &&
+            std::chrono::steady_clock::now() - entry.lastFlush >= policy_.maxDelay) {
+            doFlush = true;
+        }
+        if (doFlush) timedFlush(entry);
+    }
+
+    // out.flush() 한 번을 계측과 함께 수행하고 그룹 커밋 상태를 리셋한다.
+    // entry.mx를 잡은 상태에서 호출.
+    void timedFlush(FileEntry& entry) {
+        const std::uint64_t t0 = instr::nowNs();
+        entry.out.flush();
+        flushHist_.record(instr::nowNs() - t0);
+        flushes_.add();
+        entry.pendingBytes = 0;
+        entry.lastFlush = std::chrono::steady_clock::now();
+    }
+
+    // 완성된 레코드를 테일에 반영하고 현재 모드 경로로 내보낸다
+    void deliver(FileEntry* entry, std::string&& line, unsigned char severity = 0) {
+        if (entry->tail) { // enableTail은 설정 단계 전용 → 이후 포인터는 불변
+            std::lock_guard<std::mutex> lk(entry->mx); // 버퍼 변경만 직렬화
+            entry->tail->push_back(format_ == Format::Binary
+                                       ? line.substr(kBinaryHeaderSize)
+                                       : line.substr(0, line.size() - 1));
+        }
+
+        if (mode_ == Mode::Async) {
+            outstanding_.fetch_add(1, std::memory_order_relaxed);
+            queue_->push(LogRecord{entry, std::move(line), severity}); // 가득 차면 블로킹(배압)
+            enqueued_.add();
+            queueDepthHwm_.observe(queue_->size());
+        } else {
+            std::lock_guard<std::mutex> lk(entry->mx); // 같은 파일만 직렬화
+            const std::size_t written = line.size();
+            entry->out << line;
+            if (!entry->out.good()) {
+                throw std::runtime_error("Write failed: " + entry->fullpath);
+            }
+            entry->bytesWritten += written;
+            entry->pendingBytes += written;
+            maybeRotate(*entry);
+            applyFlushPolicy(*entry, severity);
+        }
+    }
+
+    Shard& shardOf(std::string_view filename) const {
+        return shards_[std::hash<std::string_view>{}(filename) % kShards];
+    }
+
+    // 샤드 락은 맵 조회 동안만 잡는다. 반환된 포인터는 closeLogFile로
+    // 지우기 전까지 안정적이다 (항목은 unique_ptr로 힙에 있음).
+    FileEntry* findEntry(std::string_view filename) const {
+        Shard& shard = shardOf(filename);
+        std::lock_guard<std::mutex> lk(shard.mx);
+        auto it = shard.files.find(filename);
+        return it == shard.files.end() ? nullptr : it->second.get();
+    }
+
+    template <typename Fn>
+    void forEachEntry(Fn fn) {
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lk(shard.mx);
+            for (auto& kv : shard.files) fn(*kv.second);
+        }
+    }
+
+    Mode   mode_   = Mode::Sync;
+    Format format_ = Format::Text;
+    std::array<FileEntry*, kSeverityCount> severityRoutes_{}; // 심각도별 직행 인덱스
+    mutable std::array<Shard, kShards> shards_;
+    std::unique_ptr<MpmcCircularQueue<LogRecord>> queue_;
+    std::thread writer_;
+    std::atomic<bool>        stop_{false};
+    std::atomic<std::size_t> maxFileSize_{0}; // 0이면 로테이션 없음
+    FlushPolicy policy_;
+    bool        policyActive_ = false; // setFlushPolicy 호출 여부
+    std::atomic<std::size_t> outstanding_{0}; // 큐에 넣었지만 아직 안 쓴 레코드 수
+
+    // 계측
+    instr::Counter       enqueued_;
+    instr::MaxTracker    queueDepthHwm_;
+    instr::Counter       flushes_;
+    instr::Counter       writeErrors_;
+    instr::Log2Histogram flushHist_;
+
+    // 같은 초 안에서는 캐시된 문자열을 재사용하고, 초가 바뀔 때만
+    // localtime/strftime을 다시 돌린다. 고정 스택(thread_local) 버퍼에
+    // 직접 포맷하므로 ostringstream도, 힙 할당도 없다.
+    static const char* nowTimestamp() {
+        using clock = std::chrono::system_clock;
+        static thread_local std::time_t cachedSecond = static_cast<std::time_t>(-1);
+        static thread_local char buffer[32];
+
+        const std::time_t tt = clock::to_time_t(clock::now());
+        if (tt != cachedSecond) {
+            std::tm tm{};
+            #if defined(_WIN32)
+                localtime_s(&tm, &tt);
+            #else
+                localtime_r(&tt, &tm);
+            #endif
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+            cachedSecond = tt;
+        }
+        return buffer;
+    }
+
+    // ---- Binary 포맷 보조 ----
+    static constexpr std::size_t kBinaryHeaderSize = 13; // 8 + 1 + 4
+
+    static void appendLittleEndian(std::string& out, std::uint64_t value, std::size_t bytes) {
+        for (std::size_t i = 0; i < bytes; ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    static std::uint64_t readLittleEndian(const char* p, std::size_t bytes) {
+        std::uint64_t value = 0;
+        for (std::size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    // 저장된 raw tick을 nowTimestamp와 같은 "%Y-%m-%d %H:%M:%S"로 렌더링
+    static std::string formatTicks(std::chrono::system_clock::rep ticks) {
         using clock = std::chrono::system_clock;
-        auto now = clock::now();
-        std::time_t tt = clock::to_time_t(now);
+        const clock::time_point tp{clock::duration{ticks}};
+        const std::time_t tt = clock::to_time_t(tp);
         std::tm tm{};
         #if defined(_WIN32)
             localtime_s(&tm, &tt);
         #else
-            tm = *std::localtime(&tt);
+            localtime_r(&tt, &tm);
         #endif
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-        return oss.str();
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+        return buffer;
     }
 
-    static std::string makePath(const std::string& filename) {
-        return std::string("logs/") + filename;
+    static std::string makePath(std::string_view filename) {
+        std::string path;
+        path.reserve(5 + filename.size());
+        path += "logs/";
+        path += filename;
+        return path;
     }
 
     void closeAll() {
-        writers_.clear(); // 모든 ofstream 정리
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lk(shard.mx);
+            for (auto& kv : shard.files) kv.second->out.flush();
+            shard.files.clear(); // 모든 ofstream 정리
+        }
     }
 };
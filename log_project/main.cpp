@@ -16,6 +16,9 @@ int main() {
         manager.writeLog("debug.log", "User login attempt");
         manager.writeLog("info.log", "Server started successfully");
 
+        // 메시지당 자동 flush가 사라졌으므로, 읽기 전에 명시적으로 flush
+        manager.flush();
+
         auto errorLogs = manager.readLogs("error.log");
 
         std::cout << u8"// error.log 파일 내용\n";
@@ -0,0 +1,651 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#include "../circular_buffer/Instrumentation.hpp"
+
+// ======================= ParallelProcessor =======================
+// - 고정 타입에 묶이지 않고 함수형 스타일의 parallel_map 제공
+// - 입력은 임의 접근(iterator) 컨테이너(예: std::vector) 가정
+// - 생성자에서 워커 스레드 풀을 한 번만 띄우고, parallel_map 호출마다
+//   스레드를 새로 만들지 않는다. 호출당 비용은 작업 enqueue + 완료 대기뿐이라
+//   작은 배치를 초당 수백 번 돌려도 스레드 생성/소멸 비용이 들지 않는다.
+template <typename T>
+class ParallelProcessor {
+public:
+    // 워커 배치 정책:
+    // - None     : OS 스케줄러에 맡긴다 (기본).
+    // - PinToCore: 워커 t를 코어 t에 고정한다. 멀티소켓 장비에서 스레드가
+    //   소켓을 오가며 원격 메모리를 만지는 것을 막는다. 주의: 블록→워커
+    //   배정은 공유 작업 큐에서 먼저 깬 워커가 가져가는 방식이라 호출마다
+    //   달라질 수 있다. 보장되는 것은 "워커가 코어를 떠돌지 않는다"까지이고,
+    //   특정 블록이 항상 같은 코어에서 돈다는 보장은 없다.
+    enum class Affinity { None, PinToCore };
+
+    explicit ParallelProcessor(std::size_t threads, Affinity affinity = Affinity::None)
+        : threads_(threads ? threads : std::thread::hardware_concurrency()) {
+        workers_.reserve(threads_);
+        for (std::size_t t = 0; t < threads_; ++t) {
+            workers_.emplace_back([this, t, affinity] {
+                if (affinity == Affinity::PinToCore) pinCurrentThread(t);
+                workerLoop();
+            });
+        }
+        calibrate(); // 1회 자가 보정: 순차 컷오프 + 자동 grain의 기준값
+    }
+
+    // 워커가 this를 참조하므로 복사/이동 모두 금지
+    ParallelProcessor(const ParallelProcessor&)            = delete;
+    ParallelProcessor& operator=(const ParallelProcessor&) = delete;
+
+    ~ParallelProcessor() {
+        {
+            std::lock_guard<std::mutex> lk(mx_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& th : workers_) th.join();
+    }
+
+    // 스케줄링 모드:
+    // - Static : n을 균등 블록으로 고정 분할. 원소당 비용이 균일할 때 오버헤드 최소.
+    // - Dynamic: 공유 atomic 카운터에서 grain개씩 청크를 떼어 간다.
+    //   원소당 비용이 들쭉날쭉해도 먼저 끝난 워커가 남은 청크를 가져가므로
+    //   한 워커가 마지막까지 혼자 일하는 꼬리 현상이 없다.
+    enum class Schedule { Static, Dynamic };
+    static constexpr std::size_t kDefaultGrain = 1024; // Dynamic 모드 청크 크기 (미보정 폴백)
+    static constexpr std::size_t kAutoGrain    = 0;    // 보정된 원소당 비용으로 grain 자동 산정
+
+    // 순차 컷오프: 이 개수 이하의 배치는 모든 병렬 API가 호출 스레드에서
+    // 인라인(순차) 실행된다. 자가 보정은 functor의 실제 비용을 모르므로
+    // 디스패치 고정비용만 회수되는 보수적으로 작은 초깃값을 잡는다 —
+    // 원소당 비용이 정말 싸서 더 큰 컷오프가 이득인 워크로드라면
+    // 호출자가 이 값을 직접 올려 쓰면 된다.
+    void setSequentialCutoff(std::size_t elements) noexcept { seqCutoff_ = elements; }
+    std::size_t sequential_cutoff() const noexcept { return seqCutoff_; }
+
+    // 컨테이너 전체를 받아 결과 벡터 반환
+    template <typename Func>
+    auto parallel_map(const std::vector<T>& input, Func f,
+                      Schedule schedule = Schedule::Static,
+                      std::size_t grain = kAutoGrain) const
+        -> std::vector<std::invoke_result_t<Func, T>> {
+        using Out = std::invoke_result_t<Func, T>;
+
+        const std::size_t n = input.size();
+        std::vector<Out> output(n);
+        runPartitioned(n, schedule, grain, [&](std::size_t start, std::size_t end) {
+            for (std::size_t i = start; i < end; ++i) {
+                output[i] = f(input[i]);
+            }
+        });
+        return output;
+    }
+
+    // 임의 접근 반복자 범위 버전: 컨테이너로 복사해 오지 않고 범위를 그대로
+    // 처리한다. CircularBuffer의 random-access 반복자를 바로 넘길 수 있어
+    // 링버퍼 드레인과 병렬 변환 사이의 복사 패스가 사라진다.
+    template <typename It, typename Func>
+    auto parallel_map(It first, It last, Func f,
+                      Schedule schedule = Schedule::Static,
+                      std::size_t grain = kAutoGrain) const
+        -> std::vector<std::invoke_result_t<Func, decltype(*first)>> {
+        using Out = std::invoke_result_t<Func, decltype(*first)>;
+
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        std::vector<Out> output(n);
+        runPartitioned(n, schedule, grain, [&](std::size_t start, std::size_t end) {
+            for (std::size_t i = start; i < end; ++i) {
+                output[i] = f(first[static_cast<std::ptrdiff_t>(i)]);
+            }
+        });
+        return output;
+    }
+
+    // 청크 단위 버전: 사용자 functor가 (const T* begin, const T* end, Out* out)
+    // 형태로 블록 전체를 받아 자체 (벡터화된) 내부 루프를 돌린다.
+    // 원소 단위 함수 호출 오버헤드가 없고, functor 쪽에서 SIMD를 쓸 수 있다.
+    template <typename Out, typename ChunkFunc>
+    void parallel_map_chunks(const T* input, std::size_t n, Out* output, ChunkFunc f,
+                             Schedule schedule = Schedule::Static,
+                             std::size_t grain = kAutoGrain) const {
+        runPartitioned(n, schedule, grain, [&](std::size_t start, std::size_t end) {
+            f(input + start, input + end, output + start);
+        });
+    }
+
+    // 호출자 소유 출력 버퍼에 결과를 쓴다. 미리 reserve/resize해 둔 벡터를
+    // 매 프레임 재사용하면 정상 상태(steady state)에서 힙 할당이 0이다.
+    template <typename Func, typename Out>
+    void parallel_map_into(const std::vector<T>& input, Func f, std::vector<Out>& output,
+                           Schedule schedule = Schedule::Static,
+                           std::size_t grain = kAutoGrain) const {
+        output.resize(input.size()); // capacity가 충분하면 재할당 없음
+        runPartitioned(input.size(), schedule, grain, [&](std::size_t start, std::size_t end) {
+            for (std::size_t i = start; i < end; ++i) {
+                output[i] = f(input[i]);
+            }
+        });
+    }
+
+    // 각 원소에 f(T&)를 적용 (부수효과용, 결과 버퍼 없음)
+    template <typename Func>
+    void parallel_for_each(std::vector<T>& input, Func f,
+                           Schedule schedule = Schedule::Static,
+                           std::size_t grain = kAutoGrain) const {
+        runPartitioned(input.size(), schedule, grain, [&](std::size_t start, std::size_t end) {
+            for (std::size_t i = start; i < end; ++i) {
+                f(input[i]);
+            }
+        });
+    }
+
+    // Out == T일 때 제자리 변환: input[i] = f(input[i])
+    template <typename Func>
+    void parallel_transform_inplace(std::vector<T>& input, Func f,
+                                    Schedule schedule = Schedule::Static,
+                                    std::size_t grain = kAutoGrain) const {
+        runPartitioned(input.size(), schedule, grain, [&](std::size_t start, std::size_t end) {
+            for (std::size_t i = start; i < end; ++i) {
+                input[i] = f(input[i]);
+            }
+        });
+    }
+
+    // 논블로킹 버전: 호출 스레드를 붙잡지 않고 future를 즉시 돌려준다.
+    // 프레임 N의 변환을 제출해 두고 N+1을 획득하러 간 뒤 future를 회수하면
+    // 파이프라인 단계가 겹쳐진다. 입력은 값으로 받아 공유 상태로 옮기므로
+    // (std::move 권장) 호출자가 먼저 버퍼를 버려도 안전하다.
+    // 조정자 태스크 없이 마지막으로 끝나는 블록이 promise를 채우기 때문에
+    // 풀 크기가 1이어도 교착이 없다.
+    template <typename Func>
+    auto parallel_map_async(std::vector<T> input, Func f,
+                            Schedule schedule = Schedule::Static,
+                            std::size_t grain = kAutoGrain) const
+        -> std::future<std::vector<std::invoke_result_t<Func, T>>> {
+        using Out = std::invoke_result_t<Func, T>;
+
+        struct AsyncState {
+            std::vector<T>   input;
+            std::vector<Out> output;
+            std::atomic<std::size_t> remaining{0};
+            std::atomic<std::size_t> next{0}; // Dynamic 모드 청크 커서
+            std::atomic<bool> cancelled{false};
+            std::atomic<bool> errorClaimed{false};
+            std::exception_ptr error; // 최초 예외 → future로 전달
+            std::promise<std::vector<Out>> promise;
+        };
+        auto st = std::make_shared<AsyncState>();
+        st->input = std::move(input);
+
+        const std::size_t n = st->input.size();
+        st->output.resize(n);
+        auto future = st->promise.get_future();
+        if (n <= seqCutoff_) { // 작은 배치: 제출 오버헤드가 작업량을 넘는다
+            try {
+                for (std::size_t i = 0; i < n; ++i) st->output[i] = f(st->input[i]);
+                st->promise.set_value(std::move(st->output));
+            } catch (...) {
+                st->promise.set_exception(std::current_exception());
+            }
+            return future;
+        }
+
+        const std::size_t num_threads = std::min<std::size_t>(threads_, n);
+        st->remaining.store(num_threads, std::memory_order_relaxed);
+
+        // 워커 예외는 여기로 모인다: 최초 하나만 잡고 나머지 워커를 취소
+        auto captureError = [](const std::shared_ptr<AsyncState>& s) {
+            if (!s->errorClaimed.exchange(true, std::memory_order_acq_rel)) {
+                s->error = std::current_exception();
+            }
+            s->cancelled.store(true, std::memory_order_relaxed);
+        };
+        // 마지막으로 끝나는 블록이 promise를 채운다 (예외가 있으면 예외로)
+        auto finishOne = [](const std::shared_ptr<AsyncState>& s) {
+            if (s->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (s->error) s->promise.set_exception(s->error);
+                else          s->promise.set_value(std::move(s->output));
+            }
+        };
+
+        if (schedule == Schedule::Static) {
+            const std::size_t block = n / num_threads;
+            const std::size_t rem   = n % num_threads;
+            std::size_t beginIndex = 0;
+            for (std::size_t t = 0; t < num_threads; ++t) {
+                const std::size_t count = block + (t < rem ? 1 : 0);
+                const std::size_t start = beginIndex;
+                const std::size_t end   = start + count;
+                submit([st, f, start, end, captureError, finishOne] {
+                    if (!st->cancelled.load(std::memory_order_relaxed)) {
+                        try {
+                            for (std::size_t i = start; i < end; ++i) {
+                                st->output[i] = f(st->input[i]);
+                            }
+                        } catch (...) {
+                            captureError(st);
+                        }
+                    }
+                    finishOne(st);
+                });
+                beginIndex = end;
+            }
+        } else {
+            const std::size_t step = grain ? grain : autoGrain(n);
+            for (std::size_t t = 0; t < num_threads; ++t) {
+                submit([st, f, n, step, captureError, finishOne] {
+                    while (!st->cancelled.load(std::memory_order_relaxed)) {
+                        const std::size_t start = st->next.fetch_add(step, std::memory_order_relaxed);
+                        if (start >= n) break;
+                        const std::size_t end = std::min(start + step, n);
+                        try {
+                            for (std::size_t i = start; i < end; ++i) {
+                                st->output[i] = f(st->input[i]);
+                            }
+                        } catch (...) {
+                            captureError(st);
+                        }
+                    }
+                    finishOne(st);
+                });
+            }
+        }
+        return future;
+    }
+
+    // map과 reduce를 한 번에: 스레드별 부분 누적값(캐시라인 패딩으로 false
+    // sharing 방지)에 map_f(input[i])를 접어 넣고 마지막에 한 번만 합친다.
+    // 중간 결과 벡터를 만들지 않으므로 할당도, 메모리 재패스도 없다.
+    // reduce_op는 결합법칙을 만족해야 하며 (R, R) -> R 형태다.
+    template <typename MapF, typename R, typename ReduceOp>
+    R parallel_map_reduce(const std::vector<T>& input, MapF map_f,
+                          R identity, ReduceOp reduce_op) const {
+        const std::size_t n = input.size();
+        if (n <= seqCutoff_) { // 작은 배치는 인라인 접기
+            R local = identity;
+            for (std::size_t i = 0; i < n; ++i) local = reduce_op(local, map_f(input[i]));
+            return local;
+        }
+
+        const std::size_t num_threads = std::min<std::size_t>(threads_, n);
+        struct alignas(64) Padded { R value; };
+        std::vector<Padded> partials(num_threads, Padded{identity});
+
+        const std::size_t block = n / num_threads;
+        const std::size_t rem   = n % num_threads;
+        CompletionLatch latch(num_threads);
+
+        // dispatchPartitioned와 같은 예외 전달/취소 (t별 부분합 때문에 별도 경로)
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> errorClaimed{false};
+        std::exception_ptr firstError;
+
+        std::size_t beginIndex = 0;
+        for (std::size_t t = 0; t < num_threads; ++t) {
+            const std::size_t count = block + (t < rem ? 1 : 0);
+            const std::size_t start = beginIndex;
+            const std::size_t end   = start + count;
+            submit([&, t, start, end] {
+                if (!cancelled.load(std::memory_order_relaxed)) {
+                    try {
+                        R local = partials[t].value;
+                        for (std::size_t i = start; i < end; ++i) {
+                            local = reduce_op(local, map_f(input[i]));
+                        }
+                        partials[t].value = local;
+                    } catch (...) {
+                        if (!errorClaimed.exchange(true, std::memory_order_acq_rel)) {
+                            firstError = std::current_exception();
+                        }
+                        cancelled.store(true, std::memory_order_relaxed);
+                    }
+                }
+                latch.countDown();
+            });
+            beginIndex = end;
+        }
+        latch.wait();
+        if (firstError) std::rethrow_exception(firstError);
+
+        R result = identity;
+        for (const auto& p : partials) result = reduce_op(result, p.value);
+        return result;
+    }
+
+    // 순수 리덕션: map이 항등 함수인 특수형 (accumulate의 병렬판)
+    template <typename R, typename ReduceOp>
+    R parallel_reduce(const std::vector<T>& input, R identity, ReduceOp reduce_op) const {
+        return parallel_map_reduce(input,
+                                   [](const T& v) -> R { return static_cast<R>(v); },
+                                   identity, reduce_op);
+    }
+
+    // ---- 파이프라인 빌더 ----
+    // parallel_map을 세 번 체인하면 중간 벡터 두 개를 만들고 메모리를 여섯
+    // 번 훑는다. pipeline(f1).then(f2).then(f3)은 단계 functor들을 원소
+    // 단위로 합성해 parallel_map 한 번으로 실행하므로, 메모리 접촉이
+    // 입력 1회 + 출력 1회로 줄어든다. 사용:
+    //   auto out = proc.pipeline(brighten).then(quantize).then(encode).run(input);
+    template <typename Func>
+    class Pipeline {
+    public:
+        Pipeline(const ParallelProcessor* proc, Func f)
+            : proc_(proc), fn_(std::move(f)) {}
+
+        // 다음 단계를 합성한 새 파이프라인을 돌려준다 (빌더는 값 의미론)
+        template <typename Next>
+        auto then(Next g) const {
+            auto fused = [f = fn_, g = std::move(g)](const T& v) {
+                return g(f(v));
+            };
+            return Pipeline<decltype(fused)>(proc_, std::move(fused));
+        }
+
+        // 합성된 단일 단계를 한 번의 parallel_map으로 실행
+        auto run(const std::vector<T>& input,
+                 Schedule schedule = Schedule::Static,
+                 std::size_t grain = kAutoGrain) const {
+            return proc_->parallel_map(input, fn_, schedule, grain);
+        }
+
+        // 호출자 소유 출력 버퍼 버전 (parallel_map_into와 동일한 재사용 의미)
+        template <typename Out>
+        void run_into(const std::vector<T>& input, std::vector<Out>& output,
+                      Schedule schedule = Schedule::Static,
+                      std::size_t grain = kAutoGrain) const {
+            proc_->parallel_map_into(input, fn_, output, schedule, grain);
+        }
+
+    private:
+        const ParallelProcessor* proc_;
+        Func fn_;
+    };
+
+    // 첫 단계 f로 파이프라인을 시작한다
+    template <typename Func>
+    auto pipeline(Func f) const { return Pipeline<Func>(this, std::move(f)); }
+
+    // 컨테이너 없는 인덱스/바이트 범위 작업용: [0, n)을 분할해 각 구간에
+    // body(start, end)를 호출한다 (파일 청크 파싱 등). 순차 컷오프와
+    // 스케줄/grain 의미는 다른 병렬 API와 동일하다.
+    template <typename Body>
+    void parallel_blocks(std::size_t n, Body body,
+                         Schedule schedule = Schedule::Static,
+                         std::size_t grain = kAutoGrain) const {
+        runPartitioned(n, schedule, grain, body);
+    }
+
+    std::size_t thread_count() const noexcept { return threads_; }
+
+    // ---- 핫패스 계측 스냅샷 ----
+    // runPartitioned를 지나는 모든 병렬 호출을 집계한다 (보정 프로브 제외).
+    // -DINSTR_ENABLED=0이면 전부 0이 나온다.
+    struct PerfStats {
+        std::uint64_t calls;            // 병렬(또는 컷오프 인라인) 호출 수
+        std::uint64_t wall_p50_ns;      // 호출 벽시계 시간 분위수 (log2 버킷 상한)
+        std::uint64_t wall_p95_ns;
+        std::uint64_t avg_imbalance_ns; // 호출당 (최장 - 최단 블록 시간) 평균
+    };
+    PerfStats perf_stats() const noexcept {
+        const std::uint64_t c = calls_.get();
+        return { c, wallHist_.percentile(0.5), wallHist_.percentile(0.95),
+                 c ? imbalanceNs_.get() / c : 0 };
+    }
+
+private:
+    // 블록 작업들의 완료를 기다리는 소형 래치 (atomic 카운터 + condvar)
+    class CompletionLatch {
+    public:
+        explicit CompletionLatch(std::size_t count) : remaining_(count) {}
+        void countDown() {
+            if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lk(mx_);
+                cv_.notify_one();
+            }
+        }
+        void wait() {
+            std::unique_lock<std::mutex> lk(mx_);
+            cv_.wait(lk, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+        }
+    private:
+        std::atomic<std::size_t> remaining_;
+        std::mutex mx_;
+        std::condition_variable cv_;
+    };
+
+    // 공통 실행 커널: [0, n)을 워커들에 분배해 body(start, end)를 호출하고
+    // 전부 끝날 때까지 기다린다. 모든 병렬 API가 이 위에서 동작하므로,
+    // 순차 컷오프도 여기 한 곳에서 적용된다.
+    template <typename Body>
+    void runPartitioned(std::size_t n, Schedule schedule, std::size_t grain,
+                        const Body& body) const {
+        if (n == 0) return;
+        const std::uint64_t t0 = instr::nowNs();
+        if (n <= seqCutoff_) { // 디스패치 고정비용 > 작업량 → 호출 스레드에서 실행
+            body(0, n);
+            calls_.add();
+            wallHist_.record(instr::nowNs() - t0);
+            return;
+        }
+#if INSTR_ENABLED
+        // 블록/청크 실행 시간의 최소·최대 차이로 호출당 워커 불균형을 잰다
+        std::atomic<std::uint64_t> minTask{~std::uint64_t{0}};
+        std::atomic<std::uint64_t> maxTask{0};
+        dispatchPartitioned(n, schedule, grain,
+                            [&](std::size_t start, std::size_t end) {
+            const std::uint64_t b0 = instr::nowNs();
+            body(start, end);
+            const std::uint64_t d = instr::nowNs() - b0;
+            std::uint64_t cur = minTask.load(std::memory_order_relaxed);
+            while (d < cur && !minTask.compare_exchange_weak(cur, d, std::memory_order_relaxed)) {}
+            cur = maxTask.load(std::memory_order_relaxed);
+            while (d > cur && !maxTask.compare_exchange_weak(cur, d, std::memory_order_relaxed)) {}
+        });
+        const std::uint64_t lo = minTask.load(std::memory_order_relaxed);
+        const std::uint64_t hi = maxTask.load(std::memory_order_relaxed);
+        if (hi >= lo) imbalanceNs_.add(hi - lo);
+#else
+        dispatchPartitioned(n, schedule, grain, body);
+#endif
+        calls_.add();
+        wallHist_.record(instr::nowNs() - t0);
+    }
+
+    // 컷오프 검사 없는 실제 분배 (보정 루틴도 이것을 직접 쓴다).
+    //
+    // 예외 전달/취소: functor가 던지면 std::thread 밖으로 새어 terminate되는
+    // 대신, 최초 예외 하나를 exception_ptr로 잡아 두고 공유 취소 플래그를
+    // 올린다. 다른 워커들은 다음 블록(Static)/다음 청크(Dynamic) 경계에서
+    // 이를 보고 일찍 빠지므로, 망한 프레임을 끝까지 계산하지 않는다.
+    // 전원이 내려온 뒤(latch.wait) 호출 스레드에서 그 예외를 다시 던진다.
+    template <typename Body>
+    void dispatchPartitioned(std::size_t n, Schedule schedule, std::size_t grain,
+                             const Body& body) const {
+        const std::size_t num_threads = std::min<std::size_t>(threads_, n);
+        CompletionLatch latch(num_threads);
+
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> errorClaimed{false};
+        std::exception_ptr firstError; // errorClaimed 승자만 쓴다
+
+        auto capture = [&]() noexcept {
+            if (!errorClaimed.exchange(true, std::memory_order_acq_rel)) {
+                firstError = std::current_exception();
+            }
+            cancelled.store(true, std::memory_order_relaxed);
+        };
+
+        if (schedule == Schedule::Static) {
+            const std::size_t block = n / num_threads;
+            const std::size_t rem   = n % num_threads;
+            std::size_t beginIndex = 0;
+            for (std::size_t t = 0; t < num_threads; ++t) {
+                const std::size_t count = block + (t < rem ? 1 : 0);
+                const std::size_t start = beginIndex;
+                const std::size_t end   = start + count;
+                submit([&, start, end] {
+                    if (!cancelled.load(std::memory_order_relaxed)) {
+                        try {
+                            body(start, end);
+                        } catch (...) {
+                            capture();
+                        }
+                    }
+                    latch.countDown();
+                });
+                beginIndex = end;
+            }
+        } else {
+            const std::size_t step = grain ? grain : autoGrain(n);
+            std::atomic<std::size_t> next{0}; // latch.wait()까지 살아 있음
+            for (std::size_t t = 0; t < num_threads; ++t) {
+                submit([&, step] {
+                    while (!cancelled.load(std::memory_order_relaxed)) {
+                        const std::size_t start = next.fetch_add(step, std::memory_order_relaxed);
+                        if (start >= n) break;
+                        try {
+                            body(start, std::min(start + step, n));
+                        } catch (...) {
+                            capture();
+                        }
+                    }
+                    latch.countDown();
+                });
+            }
+        }
+        latch.wait();
+        if (firstError) std::rethrow_exception(firstError);
+    }
+
+    // 시작 시 1회 자가 보정.
+    //  1) 빈 body의 디스패치 왕복 시간(여러 번 중 최소값) → 병렬화 고정비용
+    //  2) 직렬 의존 LCG 누적 루프 → 싼 원소당 비용의 프록시 (접기 불가라서
+    //     -O2에서도 실제 루프가 돈다)
+    // 컷오프는 "프록시 기준 순차 처리 시간 ≈ 디스패치 비용"이 되는 원소 수로
+    // 잡되 작게(수백 이하) 클램프한다. 프록시는 원소당 비용의 하한이라 거기서
+    // 나온 손익분기점은 상한이고, 그대로 쓰면 비싼 functor가 한참 늦게야
+    // 병렬로 넘어간다(느려지는 방향의 오판). 작게 잡으면 최악의 비용도
+    // 디스패치 왕복 한 번 수준이므로 안전하다.
+    void calibrate() {
+        using Clock = std::chrono::steady_clock;
+
+        double dispatchNs = 1e18;
+        for (int probe = 0; probe < 8; ++probe) {
+            const auto t0 = Clock::now();
+            dispatchPartitioned(threads_, Schedule::Static, kDefaultGrain,
+                                [](std::size_t, std::size_t) {});
+            const auto t1 = Clock::now();
+            dispatchNs = std::min(dispatchNs,
+                std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+
+        const std::size_t m = 1 << 16;
+        std::uint64_t acc = 1;
+        const auto t0 = Clock::now();
+        for (std::size_t i = 0; i < m; ++i) {
+            acc = acc * 6364136223846793005ULL + i; // 직렬 의존 체인
+        }
+        const auto t1 = Clock::now();
+        calibSink_ = acc; // 루프가 제거되지 않도록 결과를 살려 둔다
+        perElementNs_ = std::max(0.1,
+            std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(m));
+
+        const double breakEven = dispatchNs / perElementNs_;
+        seqCutoff_ = static_cast<std::size_t>(
+            std::min(512.0, std::max(16.0, breakEven)));
+    }
+
+    // grain 미지정(kAutoGrain) 시: 보정된 원소당 비용으로 청크당 ~100µs가
+    // 되도록 잡되, 워커당 최소 4청크가 나오도록 상한을 둔다.
+    std::size_t autoGrain(std::size_t n) const {
+        if (perElementNs_ <= 0.0) return kDefaultGrain;
+        const double targetNs = 100'000.0;
+        const auto ideal = static_cast<std::size_t>(targetNs / perElementNs_);
+        const std::size_t maxG = std::max<std::size_t>(64, n / (threads_ * 4));
+        return std::max<std::size_t>(64, std::min(ideal, maxG));
+    }
+
+    // 풀에 작업 하나를 넣는다. parallel_map이 const라서 큐 상태는 mutable.
+    void submit(std::function<void()> task) const {
+        {
+            std::lock_guard<std::mutex> lk(mx_);
+            tasks_.push(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    // 현재 스레드를 index번 코어에 고정 (코어 수로 래핑)
+    static void pinCurrentThread(std::size_t index) {
+        const unsigned cores = std::thread::hardware_concurrency();
+        if (cores == 0) return;
+#if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(),
+                              static_cast<DWORD_PTR>(1) << (index % std::min<unsigned>(cores, 64)));
+#else
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+    }
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lk(mx_);
+                cv_.wait(lk, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    std::size_t threads_;
+    std::size_t seqCutoff_ = 512;   // calibrate()가 덮어쓰는 폴백값
+    double      perElementNs_ = 0.0;
+    std::uint64_t calibSink_ = 0;
+    std::vector<std::thread> workers_;
+
+    // 계측 (parallel_map류가 const라서 mutable)
+    mutable instr::Counter       calls_;
+    mutable instr::Counter       imbalanceNs_;
+    mutable instr::Log2Histogram wallHist_;
+
+    mutable std::mutex mx_;
+    mutable std::condition_variable cv_;
+    mutable std::queue<std::function<void()>> tasks_;
+    bool stop_ = false;
+};
+// ===================== end ParallelProcessor =====================
+
+// 단일 스레드 버전(성능 비교용)
+template <typename InT, typename Func>
+auto sequential_map(const std::vector<InT>& input, Func f)
+    -> std::vector<std::invoke_result_t<Func, InT>> {
+    using Out = std::invoke_result_t<Func, InT>;
+    std::vector<Out> output(input.size());
+    for (std::size_t i = 0; i < input.size(); ++i) output[i] = f(input[i]);
+    return output;
+}
@@ -10,64 +10,7 @@
 #include <vector>
 #include <windows.h>
 
-// ======================= ParallelProcessor =======================
-// - 고정 타입에 묶이지 않고 함수형 스타일의 parallel_map 제공
-// - 입력은 임의 접근(iterator) 컨테이너(예: std::vector) 가정
-template <typename T>
-class ParallelProcessor {
-public:
-    explicit ParallelProcessor(std::size_t threads)
-        : threads_(threads ? threads : std::thread::hardware_concurrency()) {}
-
-    // 컨테이너 전체를 받아 결과 벡터 반환
-    template <typename Func>
-    auto parallel_map(const std::vector<T>& input, Func f) const
-        -> std::vector<std::invoke_result_t<Func, T>> {
-        using Out = std::invoke_result_t<Func, T>;
-
-        const std::size_t n = input.size();
-        std::vector<Out> output(n);
-        if (n == 0) return output;
-
-        const std::size_t num_threads = std::min<std::size_t>(threads_, n);
-        const std::size_t block = n / num_threads;
-        const std::size_t rem   = n % num_threads;
-
-        std::vector<std::thread> workers;
-        workers.reserve(num_threads);
-
-        std::size_t beginIndex = 0;
-        for (std::size_t t = 0; t < num_threads; ++t) {
-            const std::size_t count = block + (t < rem ? 1 : 0);
-            const std::size_t start = beginIndex;
-            const std::size_t end   = start + count;
-
-            workers.emplace_back([&, start, end, f] {
-                for (std::size_t i = start; i < end; ++i) {
-                    output[i] = f(input[i]);
-                }
-            });
-
-            beginIndex = end;
-        }
-        for (auto& th : workers) th.join();
-        return output;
-    }
-
-private:
-    std::size_t threads_;
-};
-// ===================== end ParallelProcessor =====================
-
-// 단일 스레드 버전(성능 비교용)
-template <typename InT, typename Func>
-auto sequential_map(const std::vector<InT>& input, Func f)
-    -> std::vector<std::invoke_result_t<Func, InT>> {
-    using Out = std::invoke_result_t<Func, InT>;
-    std::vector<Out> output(input.size());
-    for (std::size_t i = 0; i < input.size(); ++i) output[i] = f(input[i]);
-    return output;
-}
+#include "ParallelProcessor.hpp"
 
 int main() {
     SetConsoleOutputCP(CP_UTF8);
@@ -132,6 +75,16 @@ int main() {
     cout << "squaredPixels[1]  = " << squaredPixels[1]  << "\n";
     cout << "squaredPixels[10] = " << squaredPixels[10] << "\n\n";
 
+    // --- 4) 파이프라인 빌더: 세 단계를 원소 단위로 합성해 한 패스로 처리
+    auto quantize = [](int v) { return v / 32; };
+    auto encode   = [](int q) { return static_cast<char>('A' + q); };
+    auto encoded = processor.pipeline(brighten).then(quantize).then(encode).run(pixelData);
+
+    cout << "// pipeline(brighten).then(quantize).then(encode) 결과\n";
+    cout << "encoded[0]      = '" << encoded[0]      << "'  // (0+50)/32 = 1\n";
+    cout << "encoded[100]    = '" << encoded[100]    << "'  // (100+50)/32 = 4\n";
+    cout << "encoded[999999] = '" << encoded[999999] << "'  // 255/32 = 7\n\n";
+
     cout << "// 성능 측정 결과 출력\n";
     cout << "Processing " << N << " elements with 4 threads\n";
     cout << "Sequential time: ~" << seq_ms << "ms\n";